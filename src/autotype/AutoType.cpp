@@ -24,9 +24,10 @@
 
 #include "config-keepassx.h"
 
+#include "autotype/AutoTypeMatchIndex.h"
 #include "autotype/AutoTypePlatformPlugin.h"
 #include "autotype/AutoTypeSelectDialog.h"
-#include "autotype/WildcardMatcher.h"
+#include "autotype/WindowPattern.h"
 #include "core/AutoTypeMatch.h"
 #include "core/Config.h"
 #include "core/Database.h"
@@ -288,7 +289,7 @@ void AutoType::performGlobalAutoType(const QList<Database*>& dbList)
     QList<AutoTypeMatch> matchList;
 
     for (Database* db : dbList) {
-        const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
+        const QList<Entry*> dbEntries = matchIndex(db)->candidates(windowTitle);
         for (Entry* entry : dbEntries) {
             const QSet<QString> sequences = autoTypeSequences(entry, windowTitle).toSet();
             for (const QString& sequence : sequences) {
@@ -597,7 +598,7 @@ QList<QString> AutoType::autoTypeSequences(const Entry* entry, const QString& wi
         }
 
         if (config()->get("AutoTypeEntryURLMatch").toBool()
-            && windowMatchesUrl(windowTitle, entry->resolvePlaceholder(entry->url()))) {
+            && windowMatchesUrl(windowTitle, entry)) {
             sequenceList.append(entry->effectiveAutoTypeSequence());
         }
 
@@ -611,17 +612,26 @@ QList<QString> AutoType::autoTypeSequences(const Entry* entry, const QString& wi
     return sequenceList;
 }
 
+/**
+ * Get the index of the entries of a database that may match a window title.
+ * The index is created on first use and deleted along with the database.
+ */
+AutoTypeMatchIndex* AutoType::matchIndex(Database* db)
+{
+    // the index of a deleted database is gone as well, even if its address is reused
+    QPointer<AutoTypeMatchIndex>& index = m_matchIndexes[db];
+    if (!index) {
+        index = new AutoTypeMatchIndex(db);
+    }
+    return index;
+}
+
 /**
  * Checks if a window title matches a pattern
  */
 bool AutoType::windowMatches(const QString& windowTitle, const QString& windowPattern)
 {
-    if (windowPattern.startsWith("//") && windowPattern.endsWith("//") && windowPattern.size() >= 4) {
-        QRegExp regExp(windowPattern.mid(2, windowPattern.size() - 4), Qt::CaseInsensitive, QRegExp::RegExp2);
-        return (regExp.indexIn(windowTitle) != -1);
-    } else {
-        return WildcardMatcher(windowTitle).match(windowPattern);
-    }
+    return WindowPattern::compile(windowPattern).matches(windowTitle);
 }
 
 /**
@@ -633,6 +643,29 @@ bool AutoType::windowMatchesTitle(const QString& windowTitle, const QString& res
     return !resolvedTitle.isEmpty() && windowTitle.contains(resolvedTitle, Qt::CaseInsensitive);
 }
 
+/**
+ * Checks if a window title matches the URL of an entry
+ */
+bool AutoType::windowMatchesUrl(const QString& windowTitle, const Entry* entry)
+{
+    const QString url = entry->url();
+    if (url.contains('{')) {
+        return windowMatchesUrl(windowTitle, entry->resolvePlaceholder(url));
+    }
+
+    if (!url.isEmpty() && windowTitle.contains(url, Qt::CaseInsensitive)) {
+        return true;
+    }
+
+    // reuse the URL parsed by the entry
+    const EntryUrl parsedUrl = entry->parsedUrl();
+    if (parsedUrl.url.isValid() && !parsedUrl.url.host().isEmpty()) {
+        return windowTitle.contains(parsedUrl.host, Qt::CaseInsensitive);
+    }
+
+    return false;
+}
+
 /**
  * Checks if a window title matches an entry URL
  * The entry URL should be Spr-compiled by the caller
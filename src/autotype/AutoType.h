@@ -19,8 +19,10 @@
 #ifndef KEEPASSX_AUTOTYPE_H
 #define KEEPASSX_AUTOTYPE_H
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
+#include <QPointer>
 #include <QStringList>
 #include <QWidget>
 
@@ -28,6 +30,7 @@
 
 class AutoTypeAction;
 class AutoTypeExecutor;
+class AutoTypeMatchIndex;
 class AutoTypePlatformInterface;
 class Database;
 class Entry;
@@ -83,8 +86,10 @@ private:
     QList<AutoTypeAction*> createActionFromTemplate(const QString& tmpl, const Entry* entry);
     QList<QString> autoTypeSequences(const Entry* entry, const QString& windowTitle = QString());
     bool windowMatchesTitle(const QString& windowTitle, const QString& resolvedTitle);
+    bool windowMatchesUrl(const QString& windowTitle, const Entry* entry);
     bool windowMatchesUrl(const QString& windowTitle, const QString& resolvedUrl);
     bool windowMatches(const QString& windowTitle, const QString& windowPattern);
+    AutoTypeMatchIndex* matchIndex(Database* db);
 
     QMutex m_inAutoType;
     QMutex m_inGlobalAutoTypeDialog;
@@ -95,6 +100,8 @@ private:
     AutoTypePlatformInterface* m_plugin;
     AutoTypeExecutor* m_executor;
     WId m_windowFromGlobal;
+    // owned by the databases they index
+    QHash<const Database*, QPointer<AutoTypeMatchIndex>> m_matchIndexes;
     static AutoType* m_instance;
 
     Q_DISABLE_COPY(AutoType)
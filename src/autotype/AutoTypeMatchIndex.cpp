@@ -0,0 +1,303 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AutoTypeMatchIndex.h"
+
+#include <QSet>
+#include <QUrl>
+
+#include "autotype/WildcardMatcher.h"
+#include "autotype/WindowPattern.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+namespace
+{
+    const int TrigramLength = 3;
+
+    /**
+     * Add the texts one of which a window title has to contain to match
+     * the pattern of a window association.
+     *
+     * @return false if any window title could match the pattern
+     */
+    bool addWindowPatternNeedles(const QString& pattern, QStringList& needles)
+    {
+        if (WindowPattern::compile(pattern).isRegularExpression()) {
+            // regular expressions are not indexed
+            return false;
+        }
+
+        if (!pattern.contains(WildcardMatcher::Wildcard)) {
+            // an empty pattern only matches an empty title, which is never looked up
+            if (!pattern.isEmpty()) {
+                needles.append(pattern);
+            }
+            return true;
+        }
+
+        // every part between the wildcards is contained in a matching title
+        QString longestPart;
+        const QStringList parts = pattern.split(WildcardMatcher::Wildcard, QString::SkipEmptyParts);
+        for (const QString& part : parts) {
+            if (part.size() > longestPart.size()) {
+                longestPart = part;
+            }
+        }
+        if (longestPart.isEmpty()) {
+            return false;
+        }
+        needles.append(longestPart);
+        return true;
+    }
+
+    QSet<QString> trigrams(const QString& foldedText)
+    {
+        QSet<QString> result;
+        for (int i = 0; i + TrigramLength <= foldedText.size(); ++i) {
+            result.insert(foldedText.mid(i, TrigramLength));
+        }
+        return result;
+    }
+
+    bool containsReference(const QString& text)
+    {
+        return EntryAttributes::matchReference(text).hasMatch();
+    }
+
+    /**
+     * Collect the trigrams of the texts a matching window title must contain,
+     * mirroring the checks of AutoType::autoTypeSequences().
+     *
+     * @return false if the entry is a candidate for any window title
+     */
+    bool entryNeedleTrigrams(const Entry* entry, QList<QSet<QString>>& needleTrigrams)
+    {
+        QStringList needles;
+        const QList<AutoTypeAssociations::Association> assocList = entry->autoTypeAssociations()->getAll();
+        for (const AutoTypeAssociations::Association& assoc : assocList) {
+            if (containsReference(assoc.window)
+                || !addWindowPatternNeedles(entry->resolveMultiplePlaceholders(assoc.window), needles)) {
+                return false;
+            }
+        }
+
+        if (containsReference(entry->title()) || containsReference(entry->url())) {
+            return false;
+        }
+        needles.append(entry->resolvePlaceholder(entry->title()));
+        const QString url = entry->resolvePlaceholder(entry->url());
+        needles.append(url);
+        const QUrl parsedUrl(url);
+        if (parsedUrl.isValid()) {
+            needles.append(parsedUrl.host());
+        }
+
+        for (const QString& needle : asConst(needles)) {
+            if (needle.isEmpty()) {
+                continue;
+            }
+            const QSet<QString> needleSet = trigrams(needle.toCaseFolded());
+            if (needleSet.isEmpty()) {
+                // too short to be indexed
+                return false;
+            }
+            needleTrigrams.append(needleSet);
+        }
+        return true;
+    }
+} // namespace
+
+AutoTypeMatchIndex::AutoTypeMatchIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+    , m_valid(false)
+    , m_connections(nullptr)
+{
+    connect(db, SIGNAL(groupAdded()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupRemoved()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupMoved()), SLOT(invalidate()));
+}
+
+/**
+ * Entries of the database that may match the window title, in the order of
+ * Group::entriesRecursive(). The caller still has to check which of the
+ * candidates actually match.
+ */
+QList<Entry*> AutoTypeMatchIndex::candidates(const QString& windowTitle)
+{
+    if (!m_valid) {
+        rebuild();
+    }
+
+    QVector<bool> isCandidate = m_alwaysCandidate;
+
+    const QString foldedTitle = windowTitle.toCaseFolded();
+    for (int i = 0; i + TrigramLength <= foldedTitle.size(); ++i) {
+        auto it = m_trigramEntries.constFind(foldedTitle.mid(i, TrigramLength));
+        if (it == m_trigramEntries.constEnd()) {
+            continue;
+        }
+        for (int index : it.value()) {
+            isCandidate[index] = true;
+        }
+    }
+
+    QList<Entry*> result;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (isCandidate.at(i)) {
+            result.append(m_entries.at(i));
+        }
+    }
+    return result;
+}
+
+void AutoTypeMatchIndex::invalidate()
+{
+    m_valid = false;
+}
+
+void AutoTypeMatchIndex::rebuild()
+{
+    delete m_connections;
+    m_connections = new QObject(this);
+    m_entries.clear();
+    m_alwaysCandidate.clear();
+    m_entryNeedleTrigrams.clear();
+    m_entryTrigrams.clear();
+    m_trigramFrequency.clear();
+    m_trigramEntries.clear();
+    m_valid = true;
+
+    if (!m_db) {
+        return;
+    }
+
+    const QList<Group*> groups = m_db->rootGroup()->groupsRecursive(true);
+    for (const Group* group : groups) {
+        connect(group, &Group::entryAdded, m_connections, [this]() { invalidate(); });
+        connect(group, &Group::entryRemoved, m_connections, [this]() { invalidate(); });
+    }
+
+    const QList<Entry*> entries = m_db->rootGroup()->entriesRecursive();
+    m_entries.reserve(entries.size());
+    for (Entry* entry : entries) {
+        const int index = m_entries.size();
+        m_entries.append(entry);
+        m_alwaysCandidate.append(false);
+        m_entryNeedleTrigrams.append(QList<QSet<QString>>());
+        m_entryTrigrams.append(QStringList());
+        addEntryNeedles(index);
+        connect(entry, &Entry::modified, m_connections, [this, index]() { updateEntry(index); });
+    }
+
+    // the frequencies of all trigrams are known now
+    for (int index = 0; index < m_entries.size(); ++index) {
+        indexEntry(index);
+    }
+}
+
+void AutoTypeMatchIndex::addEntryNeedles(int entryIndex)
+{
+    const Entry* entry = m_entries.at(entryIndex);
+    if (!entry->autoTypeEnabled()) {
+        return;
+    }
+
+    QList<QSet<QString>> needleTrigrams;
+    if (!entryNeedleTrigrams(entry, needleTrigrams)) {
+        m_alwaysCandidate[entryIndex] = true;
+        return;
+    }
+
+    for (const QSet<QString>& needleSet : asConst(needleTrigrams)) {
+        for (const QString& trigram : needleSet) {
+            ++m_trigramFrequency[trigram];
+        }
+    }
+    m_entryNeedleTrigrams[entryIndex] = needleTrigrams;
+}
+
+void AutoTypeMatchIndex::removeEntryNeedles(int entryIndex)
+{
+    for (const QSet<QString>& needleSet : asConst(m_entryNeedleTrigrams.at(entryIndex))) {
+        for (const QString& trigram : needleSet) {
+            auto it = m_trigramFrequency.find(trigram);
+            if (it != m_trigramFrequency.end() && --it.value() <= 0) {
+                m_trigramFrequency.erase(it);
+            }
+        }
+    }
+    m_entryNeedleTrigrams[entryIndex].clear();
+    m_alwaysCandidate[entryIndex] = false;
+}
+
+/**
+ * Index every needle of an entry by its least common trigram to keep the candidate lists short.
+ */
+void AutoTypeMatchIndex::indexEntry(int entryIndex)
+{
+    QStringList& entryTrigrams = m_entryTrigrams[entryIndex];
+    for (const QSet<QString>& needleSet : asConst(m_entryNeedleTrigrams.at(entryIndex))) {
+        QString rarestTrigram;
+        int rarestFrequency = 0;
+        for (const QString& trigram : needleSet) {
+            const int frequency = m_trigramFrequency.value(trigram);
+            if (rarestTrigram.isEmpty() || frequency < rarestFrequency) {
+                rarestTrigram = trigram;
+                rarestFrequency = frequency;
+            }
+        }
+
+        if (!entryTrigrams.contains(rarestTrigram)) {
+            entryTrigrams.append(rarestTrigram);
+            m_trigramEntries[rarestTrigram].append(entryIndex);
+        }
+    }
+}
+
+void AutoTypeMatchIndex::unindexEntry(int entryIndex)
+{
+    for (const QString& trigram : asConst(m_entryTrigrams.at(entryIndex))) {
+        auto it = m_trigramEntries.find(trigram);
+        if (it == m_trigramEntries.end()) {
+            continue;
+        }
+        it.value().remove(it.value().indexOf(entryIndex));
+        if (it.value().isEmpty()) {
+            m_trigramEntries.erase(it);
+        }
+    }
+    m_entryTrigrams[entryIndex].clear();
+}
+
+/**
+ * Re-index a single entry after it has been modified, e.g. its title,
+ * URL or window associations changed.
+ */
+void AutoTypeMatchIndex::updateEntry(int entryIndex)
+{
+    if (!m_valid) {
+        return;
+    }
+    unindexEntry(entryIndex);
+    removeEntryNeedles(entryIndex);
+    addEntryNeedles(entryIndex);
+    indexEntry(entryIndex);
+}
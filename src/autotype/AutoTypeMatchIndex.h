@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_AUTOTYPEMATCHINDEX_H
+#define KEEPASSXC_AUTOTYPEMATCHINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+class Database;
+class Entry;
+
+/**
+ * Index of the entries of a database by the window titles they can match.
+ *
+ * Every way an entry can match a window title (its window associations,
+ * its title and its URL) requires the title to contain some literal text.
+ * The index maps one trigram of that text to the entry, so a window title
+ * only needs to be checked against the entries sharing one of its trigrams.
+ * Entries with patterns that cannot be indexed, like regular expressions,
+ * are always candidates.
+ *
+ * A modified entry is re-indexed on its own. Entries whose texts contain
+ * references to other entries are always candidates, since changes to the
+ * referenced entries are not tracked. Added, removed or moved entries and
+ * groups rebuild the index lazily.
+ */
+class AutoTypeMatchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutoTypeMatchIndex(Database* db);
+
+    QList<Entry*> candidates(const QString& windowTitle);
+
+private slots:
+    void invalidate();
+
+private:
+    void rebuild();
+    void addEntryNeedles(int entryIndex);
+    void removeEntryNeedles(int entryIndex);
+    void indexEntry(int entryIndex);
+    void unindexEntry(int entryIndex);
+    void updateEntry(int entryIndex);
+
+    QPointer<Database> m_db;
+    bool m_valid;
+    // receiver of the connections to the indexed entries and groups, replaced on rebuild
+    QObject* m_connections;
+    QVector<Entry*> m_entries;
+    QVector<bool> m_alwaysCandidate;
+    // trigram sets of the texts each entry requires, and the trigram each set is indexed by
+    QVector<QList<QSet<QString>>> m_entryNeedleTrigrams;
+    QVector<QStringList> m_entryTrigrams;
+    QHash<QString, int> m_trigramFrequency;
+    QHash<QString, QVector<int>> m_trigramEntries;
+};
+
+#endif // KEEPASSXC_AUTOTYPEMATCHINDEX_H
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WindowPattern.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "autotype/WildcardMatcher.h"
+
+namespace
+{
+    const int MaxCachedPatterns = 16384;
+    const Qt::CaseSensitivity Sensitivity = Qt::CaseInsensitive;
+
+    QMutex& patternCacheMutex()
+    {
+        static QMutex mutex;
+        return mutex;
+    }
+
+    QCache<QString, WindowPattern>& patternCache()
+    {
+        static QCache<QString, WindowPattern> cache(MaxCachedPatterns);
+        return cache;
+    }
+} // namespace
+
+WindowPattern::WindowPattern(const QString& pattern)
+    : m_pattern(pattern)
+{
+    if (pattern.startsWith("//") && pattern.endsWith("//") && pattern.size() >= 4) {
+        m_type = RegularExpression;
+        QRegularExpression::PatternOptions options = QRegularExpression::CaseInsensitiveOption;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0) && QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
+        // newer versions always optimize (and JIT compile) patterns on first use
+        options |= QRegularExpression::OptimizeOnFirstUsageOption;
+#endif
+        m_regExp = QRegularExpression(pattern.mid(2, pattern.size() - 4), options);
+    } else if (pattern.contains(WildcardMatcher::Wildcard)) {
+        m_type = Wildcard;
+        m_parts = pattern.split(WildcardMatcher::Wildcard, QString::KeepEmptyParts);
+    } else {
+        m_type = Exact;
+    }
+}
+
+/**
+ * Get the compiled pattern from the shared cache, compiling it if needed.
+ */
+WindowPattern WindowPattern::compile(const QString& pattern)
+{
+    QMutexLocker locker(&patternCacheMutex());
+    QCache<QString, WindowPattern>& cache = patternCache();
+    if (const WindowPattern* cached = cache.object(pattern)) {
+        return *cached;
+    }
+
+    auto* compiled = new WindowPattern(pattern);
+    const WindowPattern result = *compiled;
+    cache.insert(pattern, compiled);
+    return result;
+}
+
+/**
+ * Check if the window title matches the pattern, with the same semantics as
+ * WildcardMatcher for wildcard patterns. Matching is case insensitive.
+ */
+bool WindowPattern::matches(const QString& windowTitle) const
+{
+    switch (m_type) {
+    case Exact:
+        return windowTitle.compare(m_pattern, Sensitivity) == 0;
+    case RegularExpression:
+        return m_regExp.match(windowTitle).hasMatch();
+    case Wildcard:
+        break;
+    }
+
+    if (!windowTitle.startsWith(m_parts.first(), Sensitivity) || !windowTitle.endsWith(m_parts.last(), Sensitivity)) {
+        return false;
+    }
+
+    int index = 0;
+    for (const QString& part : m_parts) {
+        const int matchIndex = windowTitle.indexOf(part, index, Sensitivity);
+        if (matchIndex == -1) {
+            return false;
+        }
+        index = matchIndex + part.length();
+    }
+    return true;
+}
+
+bool WindowPattern::isRegularExpression() const
+{
+    return m_type == RegularExpression;
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_WINDOWPATTERN_H
+#define KEEPASSXC_WINDOWPATTERN_H
+
+#include <QRegularExpression>
+#include <QStringList>
+
+/**
+ * Compiled window pattern of an auto-type association.
+ *
+ * Patterns enclosed in // are regular expressions, all other patterns are
+ * wildcard patterns as described in WildcardMatcher. The pattern is parsed
+ * once; compile() additionally shares compiled patterns between all callers
+ * so repeated matching against the same associations does not recompile them.
+ */
+class WindowPattern
+{
+public:
+    explicit WindowPattern(const QString& pattern = QString());
+
+    static WindowPattern compile(const QString& pattern);
+
+    bool matches(const QString& windowTitle) const;
+    bool isRegularExpression() const;
+
+private:
+    enum Type
+    {
+        Exact,
+        Wildcard,
+        RegularExpression
+    };
+
+    Type m_type;
+    QString m_pattern;
+    // the texts between the wildcards, the first and last are anchored
+    QStringList m_parts;
+    QRegularExpression m_regExp;
+};
+
+#endif // KEEPASSXC_WINDOWPATTERN_H
@@ -30,6 +30,7 @@ BrowserAction::BrowserAction(BrowserService& browserService)
     : m_mutex(QMutex::Recursive)
     , m_browserService(browserService)
     , m_associated(false)
+    , m_request(nullptr)
 {
 }
 
@@ -62,6 +63,49 @@ QJsonObject BrowserAction::readResponse(const QJsonObject& json)
     return handleAction(json);
 }
 
+/**
+ * Decrypt the message of a request ahead of handleRequest(), this is thread safe.
+ * The keys are read under m_keyMutex only, see keySnapshot().
+ */
+void BrowserAction::decryptRequest(Request& request)
+{
+    const QString action = request.json.value("action").toString();
+    const QString message = request.json.value("message").toString();
+    const QString nonce = request.json.value("nonce").toString();
+    if (message.isEmpty() || nonce.isEmpty()) {
+        return;
+    }
+
+    request.decrypted = decryptJson(message, nonce, action);
+    request.isDecrypted = true;
+}
+
+/**
+ * Handle a request on the GUI thread, using the message decrypted by
+ * decryptRequest() and leaving the encryption of the response message to
+ * encryptResponse().
+ */
+void BrowserAction::handleRequest(Request& request)
+{
+    QMutexLocker locker(&m_mutex);
+    m_request = &request;
+    request.response = readResponse(request.json);
+    m_request = nullptr;
+}
+
+/**
+ * Encrypt the message of the response of a request handled by handleRequest(),
+ * this is thread safe.
+ */
+void BrowserAction::encryptResponse(Request& request)
+{
+    if (!request.plainMessage.isEmpty()) {
+        request.response["message"] =
+            encryptMessage(request.plainMessage, request.response.value("nonce").toString());
+        request.plainMessage = QJsonObject();
+    }
+}
+
 // Private functions
 ///////////////////////
 
@@ -82,6 +126,8 @@ QJsonObject BrowserAction::handleAction(const QJsonObject& json)
         return handleTestAssociate(json, action);
     } else if (action.compare("get-logins", Qt::CaseSensitive) == 0) {
         return handleGetLogins(json, action);
+    } else if (action.compare("get-logins-batch", Qt::CaseSensitive) == 0) {
+        return handleGetLoginsBatch(json, action);
     } else if (action.compare("generate-password", Qt::CaseSensitive) == 0) {
         return handleGeneratePassword(json, action);
     } else if (action.compare("set-login", Qt::CaseSensitive) == 0) {
@@ -111,9 +157,12 @@ QJsonObject BrowserAction::handleChangePublicKeys(const QJsonObject& json, const
 
     const QString publicKey = getBase64FromKey(pk, crypto_box_PUBLICKEYBYTES);
     const QString secretKey = getBase64FromKey(sk, crypto_box_SECRETKEYBYTES);
-    m_clientPublicKey = clientPublicKey;
-    m_publicKey = publicKey;
-    m_secretKey = secretKey;
+    {
+        QMutexLocker keyLocker(&m_keyMutex);
+        m_clientPublicKey = clientPublicKey;
+        m_publicKey = publicKey;
+        m_secretKey = secretKey;
+    }
 
     QJsonObject response = buildMessage(incrementNonce(nonce));
     response["action"] = action;
@@ -240,14 +289,7 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
         return getErrorReply(action, ERROR_KEEPASS_NO_URL_PROVIDED);
     }
 
-    const QJsonArray keys = decrypted.value("keys").toArray();
-
-    StringPairList keyList;
-    for (const QJsonValue val : keys) {
-        const QJsonObject keyObject = val.toObject();
-        keyList.push_back(qMakePair(keyObject.value("id").toString(), keyObject.value("key").toString()));
-    }
-
+    const StringPairList keyList = getKeyList(decrypted);
     const QString id = decrypted.value("id").toString();
     const QString submit = decrypted.value("submitUrl").toString();
     const QJsonArray users = m_browserService.findMatchingEntries(id, url, submit, "", keyList);
@@ -267,6 +309,73 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
     return buildResponse(action, message, newNonce);
 }
 
+/**
+ * Get the logins for several URLs in one message, e.g. for all frames of a
+ * page. The "urls" array holds objects with "url" and "submitUrl", the
+ * response has a "results" array with "url", "count" and "entries" for each
+ * of them in the same order. Entries needing the user's permission are
+ * confirmed in a single dialog for the whole batch.
+ */
+QJsonObject BrowserAction::handleGetLoginsBatch(const QJsonObject& json, const QString& action)
+{
+    const QString hash = getDatabaseHash();
+    const QString nonce = json.value("nonce").toString();
+    const QString encrypted = json.value("message").toString();
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_associated) {
+        return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
+    }
+
+    const QJsonObject decrypted = decryptMessage(encrypted, nonce, action);
+    if (decrypted.isEmpty()) {
+        return getErrorReply(action, ERROR_KEEPASS_CANNOT_DECRYPT_MESSAGE);
+    }
+
+    // empty URLs keep their place with an empty result, so results[i] always belongs to urls[i]
+    StringPairList urls;
+    bool urlProvided = false;
+    const QJsonArray urlArray = decrypted.value("urls").toArray();
+    for (const QJsonValue val : urlArray) {
+        const QJsonObject urlObject = val.toObject();
+        const QString url = urlObject.value("url").toString();
+        urls.push_back(qMakePair(url, urlObject.value("submitUrl").toString()));
+        urlProvided |= !url.isEmpty();
+    }
+    if (!urlProvided) {
+        return getErrorReply(action, ERROR_KEEPASS_NO_URL_PROVIDED);
+    }
+
+    const QString id = decrypted.value("id").toString();
+    const QJsonArray entries = m_browserService.findMatchingEntries(id, urls, getKeyList(decrypted));
+
+    int count = 0;
+    QJsonArray results;
+    for (int i = 0; i < urls.size(); ++i) {
+        const QJsonArray users = entries.at(i).toArray();
+        QJsonObject result;
+        result["url"] = urls.at(i).first;
+        result["count"] = users.count();
+        result["entries"] = users;
+        results.append(result);
+        count += users.count();
+    }
+
+    if (count == 0) {
+        return getErrorReply(action, ERROR_KEEPASS_NO_LOGINS_FOUND);
+    }
+
+    const QString newNonce = incrementNonce(nonce);
+
+    QJsonObject message = buildMessage(newNonce);
+    message["count"] = count;
+    message["results"] = results;
+    message["hash"] = hash;
+    message["id"] = id;
+
+    return buildResponse(action, message, newNonce);
+}
+
 QJsonObject BrowserAction::handleGeneratePassword(const QJsonObject& json, const QString& action)
 {
     const QString nonce = json.value("nonce").toString();
@@ -386,7 +495,12 @@ QJsonObject BrowserAction::buildResponse(const QString& action, const QJsonObjec
 {
     QJsonObject response;
     response["action"] = action;
-    response["message"] = encryptMessage(message, nonce);
+    if (m_request) {
+        // encrypted by encryptResponse()
+        m_request->plainMessage = message;
+    } else {
+        response["message"] = encryptMessage(message, nonce);
+    }
     response["nonce"] = nonce;
     return response;
 }
@@ -455,6 +569,17 @@ QString BrowserAction::encryptMessage(const QJsonObject& message, const QString&
 }
 
 QJsonObject BrowserAction::decryptMessage(const QString& message, const QString& nonce, const QString& action)
+{
+    if (m_request && m_request->isDecrypted && message == m_request->json.value("message").toString()
+        && nonce == m_request->json.value("nonce").toString()) {
+        // decrypted by decryptRequest()
+        return m_request->decrypted;
+    }
+
+    return decryptJson(message, nonce, action);
+}
+
+QJsonObject BrowserAction::decryptJson(const QString& message, const QString& nonce, const QString& action)
 {
     if (message.isEmpty() || nonce.isEmpty()) {
         return QJsonObject();
@@ -470,11 +595,14 @@ QJsonObject BrowserAction::decryptMessage(const QString& message, const QString&
 
 QString BrowserAction::encrypt(const QString& plaintext, const QString& nonce)
 {
-    QMutexLocker locker(&m_mutex);
+    QString clientPublicKey;
+    QString secretKey;
+    keySnapshot(clientPublicKey, secretKey);
+
     const QByteArray ma = plaintext.toUtf8();
     const QByteArray na = base64Decode(nonce);
-    const QByteArray ca = base64Decode(m_clientPublicKey);
-    const QByteArray sa = base64Decode(m_secretKey);
+    const QByteArray ca = base64Decode(clientPublicKey);
+    const QByteArray sa = base64Decode(secretKey);
 
     std::vector<unsigned char> m(ma.cbegin(), ma.cend());
     std::vector<unsigned char> n(na.cbegin(), na.cend());
@@ -498,11 +626,14 @@ QString BrowserAction::encrypt(const QString& plaintext, const QString& nonce)
 
 QByteArray BrowserAction::decrypt(const QString& encrypted, const QString& nonce)
 {
-    QMutexLocker locker(&m_mutex);
+    QString clientPublicKey;
+    QString secretKey;
+    keySnapshot(clientPublicKey, secretKey);
+
     const QByteArray ma = base64Decode(encrypted);
     const QByteArray na = base64Decode(nonce);
-    const QByteArray ca = base64Decode(m_clientPublicKey);
-    const QByteArray sa = base64Decode(m_secretKey);
+    const QByteArray ca = base64Decode(clientPublicKey);
+    const QByteArray sa = base64Decode(secretKey);
 
     std::vector<unsigned char> m(ma.cbegin(), ma.cend());
     std::vector<unsigned char> n(na.cbegin(), na.cend());
@@ -523,6 +654,18 @@ QByteArray BrowserAction::decrypt(const QString& encrypted, const QString& nonce
     return QByteArray();
 }
 
+/**
+ * Copy the keys used by encrypt() and decrypt(). Those run on worker threads
+ * for decryptRequest() and encryptResponse(), so they must not wait for
+ * m_mutex, which the GUI thread holds while a request shows dialogs.
+ */
+void BrowserAction::keySnapshot(QString& clientPublicKey, QString& secretKey)
+{
+    QMutexLocker locker(&m_keyMutex);
+    clientPublicKey = m_clientPublicKey;
+    secretKey = m_secretKey;
+}
+
 QString BrowserAction::getBase64FromKey(const uchar* array, const uint len)
 {
     return getQByteArray(array, len).toBase64();
@@ -558,6 +701,17 @@ QByteArray BrowserAction::base64Decode(const QString& str)
     return QByteArray::fromBase64(str.toUtf8());
 }
 
+StringPairList BrowserAction::getKeyList(const QJsonObject& decrypted) const
+{
+    StringPairList keyList;
+    const QJsonArray keys = decrypted.value("keys").toArray();
+    for (const QJsonValue val : keys) {
+        const QJsonObject keyObject = val.toObject();
+        keyList.push_back(qMakePair(keyObject.value("id").toString(), keyObject.value("key").toString()));
+    }
+    return keyList;
+}
+
 QString BrowserAction::incrementNonce(const QString& nonce)
 {
     const QByteArray nonceArray = base64Decode(nonce);
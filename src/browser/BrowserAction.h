@@ -49,10 +49,29 @@ class BrowserAction : public QObject
     };
 
 public:
+    /**
+     * A request handled in stages, so the message crypto can run on a worker
+     * thread: decryptRequest() and encryptResponse() only use the keys of the
+     * client, handleRequest() accesses the database and has to run on the GUI
+     * thread. The stages of one request have to finish before the next
+     * request of the same client is started.
+     */
+    struct Request
+    {
+        QJsonObject json;
+        QJsonObject decrypted;
+        bool isDecrypted = false;
+        QJsonObject plainMessage;
+        QJsonObject response;
+    };
+
     BrowserAction(BrowserService& browserService);
     ~BrowserAction() = default;
 
     QJsonObject readResponse(const QJsonObject& json);
+    void decryptRequest(Request& request);
+    void handleRequest(Request& request);
+    void encryptResponse(Request& request);
 
 private:
     QJsonObject handleAction(const QJsonObject& json);
@@ -61,6 +80,7 @@ private:
     QJsonObject handleAssociate(const QJsonObject& json, const QString& action);
     QJsonObject handleTestAssociate(const QJsonObject& json, const QString& action);
     QJsonObject handleGetLogins(const QJsonObject& json, const QString& action);
+    QJsonObject handleGetLoginsBatch(const QJsonObject& json, const QString& action);
     QJsonObject handleGeneratePassword(const QJsonObject& json, const QString& action);
     QJsonObject handleSetLogin(const QJsonObject& json, const QString& action);
     QJsonObject handleLockDatabase(const QJsonObject& json, const QString& action);
@@ -73,8 +93,10 @@ private:
 
     QString encryptMessage(const QJsonObject& message, const QString& nonce);
     QJsonObject decryptMessage(const QString& message, const QString& nonce, const QString& action = QString());
+    QJsonObject decryptJson(const QString& message, const QString& nonce, const QString& action);
     QString encrypt(const QString& plaintext, const QString& nonce);
     QByteArray decrypt(const QString& encrypted, const QString& nonce);
+    void keySnapshot(QString& clientPublicKey, QString& secretKey);
 
     QString getBase64FromKey(const uchar* array, const uint len);
     QByteArray getQByteArray(const uchar* array, const uint len) const;
@@ -82,14 +104,18 @@ private:
     QJsonObject getJsonObject(const QByteArray& ba) const;
     QByteArray base64Decode(const QString& str);
     QString incrementNonce(const QString& nonce);
+    StringPairList getKeyList(const QJsonObject& decrypted) const;
 
 private:
     QMutex m_mutex;
+    // guards the keys, which are also read by the crypto on worker threads
+    QMutex m_keyMutex;
     BrowserService& m_browserService;
     QString m_clientPublicKey;
     QString m_publicKey;
     QString m_secretKey;
     bool m_associated;
+    Request* m_request;
 };
 
 #endif // BROWSERACTION_H
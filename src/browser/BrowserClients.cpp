@@ -43,6 +43,27 @@ QJsonObject BrowserClients::readResponse(const QByteArray& arr)
     return json;
 }
 
+/**
+ * Parse and decrypt a message for handling it with BrowserAction::handleRequest(),
+ * this is thread safe.
+ *
+ * @return the action of the client that sent the message or null
+ */
+QSharedPointer<BrowserAction> BrowserClients::prepareRequest(const QByteArray& arr, BrowserAction::Request& request)
+{
+    request.json = byteArrayToJson(arr);
+    const QString clientID = getClientID(request.json);
+    if (clientID.isEmpty()) {
+        return {};
+    }
+
+    const QSharedPointer<BrowserAction> browserAction = getClient(clientID)->browserAction;
+    if (browserAction) {
+        browserAction->decryptRequest(request);
+    }
+    return browserAction;
+}
+
 QJsonObject BrowserClients::byteArrayToJson(const QByteArray& arr) const
 {
     QJsonObject json;
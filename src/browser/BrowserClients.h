@@ -46,6 +46,7 @@ public:
     ~BrowserClients() = default;
 
     QJsonObject readResponse(const QByteArray& arr);
+    QSharedPointer<BrowserAction> prepareRequest(const QByteArray& arr, BrowserAction::Request& request);
 
 private:
     QJsonObject byteArrayToJson(const QByteArray& arr) const;
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserHostIndex.h"
+
+#include <algorithm>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+BrowserHostIndex::BrowserHostIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+    , m_valid(false)
+    , m_connections(nullptr)
+{
+    connect(db, SIGNAL(groupAdded()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupRemoved()), SLOT(invalidate()));
+    connect(db, SIGNAL(groupMoved()), SLOT(invalidate()));
+}
+
+/**
+ * Entries with a URL on the hostname or one of its parent domains down to
+ * the base domain, e.g. www.example.co.uk, example.co.uk. The entries are
+ * returned in the order of Group::entriesRecursive().
+ */
+QList<BrowserHostIndex::Match> BrowserHostIndex::lookup(const QString& hostname, const QString& baseDomain)
+{
+    if (!m_valid) {
+        rebuild();
+    }
+
+    QVector<const IndexedUrl*> found;
+    QString host = hostname.toLower();
+    const QString base = baseDomain.toLower();
+    while (!host.isEmpty()) {
+        auto it = m_hostEntries.constFind(host);
+        if (it != m_hostEntries.constEnd()) {
+            for (const IndexedUrl& indexedUrl : it.value()) {
+                found.append(&indexedUrl);
+            }
+        }
+
+        const int pos = host.indexOf('.');
+        if (base.isEmpty() || host == base || pos < 0 || !host.endsWith(base)) {
+            break;
+        }
+        host = host.mid(pos + 1);
+    }
+
+    std::sort(found.begin(), found.end(), [](const IndexedUrl* lhs, const IndexedUrl* rhs) {
+        return lhs->entryIndex < rhs->entryIndex;
+    });
+
+    QList<Match> result;
+    for (const IndexedUrl* indexedUrl : asConst(found)) {
+        result.append({m_entries.at(indexedUrl->entryIndex), indexedUrl->scheme, indexedUrl->port});
+    }
+    return result;
+}
+
+void BrowserHostIndex::invalidate()
+{
+    m_valid = false;
+}
+
+void BrowserHostIndex::rebuild()
+{
+    delete m_connections;
+    m_connections = new QObject(this);
+    m_entries.clear();
+    m_entryHosts.clear();
+    m_groupSearching.clear();
+    m_hostEntries.clear();
+    m_valid = true;
+
+    if (!m_db) {
+        return;
+    }
+    addEntries(m_db->rootGroup(), m_db->rootGroup()->resolveSearchingEnabled());
+}
+
+/**
+ * Index the entries of a group and its children. Entries and groups that are
+ * not searchable are not indexed, but changes to them are still observed.
+ */
+void BrowserHostIndex::addEntries(Group* group, bool searchable)
+{
+    m_groupSearching.insert(group, group->searchingEnabled());
+    connect(group, &Group::entryAdded, m_connections, [this]() { invalidate(); });
+    connect(group, &Group::entryRemoved, m_connections, [this]() { invalidate(); });
+    connect(group, &Group::modified, m_connections, [this, group]() { updateGroup(group); });
+
+    if (searchable) {
+        const QList<Entry*> entries = group->entries();
+        for (Entry* entry : entries) {
+            const int index = m_entries.size();
+            m_entries.append(entry);
+            m_entryHosts.append(QString());
+            addUrl(index);
+            connect(entry, &Entry::modified, m_connections, [this, index]() { updateEntry(index); });
+        }
+    }
+
+    // skip the same groups as EntrySearcher
+    const QList<Group*> children = group->children();
+    for (Group* child : children) {
+        addEntries(child, searchable && child->searchingEnabled() != Group::Disable);
+    }
+}
+
+void BrowserHostIndex::addUrl(int entryIndex)
+{
+    const EntryUrl url = m_entries.at(entryIndex)->parsedUrl();
+    m_entryHosts[entryIndex] = url.host;
+    if (url.host.isEmpty()) {
+        return;
+    }
+
+    // keep the entries of a host in the order of Group::entriesRecursive()
+    QVector<IndexedUrl>& hostEntries = m_hostEntries[url.host];
+    auto it = std::lower_bound(hostEntries.begin(), hostEntries.end(), entryIndex,
+                               [](const IndexedUrl& indexedUrl, int index) { return indexedUrl.entryIndex < index; });
+    hostEntries.insert(it, {entryIndex, url.scheme, url.port});
+}
+
+void BrowserHostIndex::removeUrl(int entryIndex)
+{
+    const QString host = m_entryHosts.at(entryIndex);
+    auto hostIt = m_hostEntries.find(host);
+    if (hostIt == m_hostEntries.end()) {
+        return;
+    }
+
+    QVector<IndexedUrl>& hostEntries = hostIt.value();
+    for (int i = 0; i < hostEntries.size(); ++i) {
+        if (hostEntries.at(i).entryIndex == entryIndex) {
+            hostEntries.remove(i);
+            break;
+        }
+    }
+    if (hostEntries.isEmpty()) {
+        m_hostEntries.erase(hostIt);
+    }
+}
+
+/**
+ * Re-index a single entry after it has been modified, e.g. its URL changed.
+ */
+void BrowserHostIndex::updateEntry(int entryIndex)
+{
+    if (!m_valid) {
+        return;
+    }
+    removeUrl(entryIndex);
+    addUrl(entryIndex);
+}
+
+/**
+ * Groups are modified by many changes, only a changed searchability requires a rebuild.
+ */
+void BrowserHostIndex::updateGroup(const Group* group)
+{
+    if (m_valid && group->searchingEnabled() != m_groupSearching.value(group)) {
+        invalidate();
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERHOSTINDEX_H
+#define KEEPASSXC_BROWSERHOSTINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include "core/Group.h"
+
+class Database;
+class Entry;
+
+/**
+ * Index of the entries of a database by the host of their URL.
+ *
+ * Looking up a host returns the entries whose URL points to the host or one
+ * of its parent domains, together with the scheme and port of their URL, so
+ * the browser integration does not have to search and parse every entry of
+ * the database for each request.
+ *
+ * When the URL of an indexed entry changes, only that entry is updated.
+ * Structural changes, i.e. added, removed or moved entries and groups and
+ * changes to the searchability of groups, rebuild the index lazily.
+ */
+class BrowserHostIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Match
+    {
+        Entry* entry;
+        QString scheme;
+        int port;
+    };
+
+    explicit BrowserHostIndex(Database* db);
+
+    QList<Match> lookup(const QString& hostname, const QString& baseDomain);
+
+private slots:
+    void invalidate();
+
+private:
+    struct IndexedUrl
+    {
+        int entryIndex;
+        QString scheme;
+        int port;
+    };
+
+    void rebuild();
+    void addEntries(Group* group, bool searchable);
+    void addUrl(int entryIndex);
+    void removeUrl(int entryIndex);
+    void updateEntry(int entryIndex);
+    void updateGroup(const Group* group);
+
+    QPointer<Database> m_db;
+    bool m_valid;
+    // receiver of the connections to the indexed entries and groups, replaced on rebuild
+    QObject* m_connections;
+    QVector<Entry*> m_entries;
+    QVector<QString> m_entryHosts;
+    QHash<const Group*, Group::TriState> m_groupSearching;
+    QHash<QString, QVector<IndexedUrl>> m_hostEntries;
+};
+
+#endif // KEEPASSXC_BROWSERHOSTINDEX_H
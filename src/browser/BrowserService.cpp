@@ -27,12 +27,13 @@
 #include "BrowserAccessControlDialog.h"
 #include "BrowserEntryConfig.h"
 #include "BrowserEntrySaveDialog.h"
+#include "BrowserHostIndex.h"
 #include "BrowserSettings.h"
 #include "core/Database.h"
-#include "core/EntrySearcher.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordGenerator.h"
+#include "core/Tools.h"
 #include "gui/MainWindow.h"
 
 const char BrowserService::KEEPASSXCBROWSER_NAME[] = "KeePassXC-Browser Settings";
@@ -222,47 +223,130 @@ QJsonArray BrowserService::findMatchingEntries(const QString& id,
         return result;
     }
 
+    const QList<QList<Entry*>> entries{searchEntries(url, keyList)};
+    return matchingEntries(entries, {qMakePair(url, submitUrl)}, realm).first().toArray();
+}
+
+/**
+ * Find the entries matching several URLs at once, for example all frames of a
+ * page. The databases are selected once and every distinct host is only
+ * searched once.
+ *
+ * @param urls pairs of URL and submit URL, an empty URL matches no entries
+ * @return an array with the matching entries for each of the URLs
+ */
+QJsonArray BrowserService::findMatchingEntries(const QString& id,
+                                               const StringPairList& urls,
+                                               const StringPairList& keyList)
+{
+    QJsonArray result;
+    if (thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(this,
+                                  "findMatchingEntries",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(QJsonArray, result),
+                                  Q_ARG(QString, id),
+                                  Q_ARG(StringPairList, urls),
+                                  Q_ARG(StringPairList, keyList));
+        return result;
+    }
+
+    const QList<Database*> databases = searchDatabases(keyList);
+    QHash<QString, QList<Entry*>> searchResults;
+    QList<QList<Entry*>> entries;
+    for (const StringPair& url : urls) {
+        if (url.first.isEmpty()) {
+            entries.append(QList<Entry*>());
+            continue;
+        }
+
+        // the search depends on the scheme, host and port of the URL only
+        const QUrl qUrl(url.first);
+        const QString searchKey = qUrl.toString(QUrl::RemoveUserInfo | QUrl::RemovePath | QUrl::RemoveQuery
+                                                | QUrl::RemoveFragment);
+        auto it = searchResults.find(searchKey);
+        if (it == searchResults.end()) {
+            it = searchResults.insert(searchKey, searchEntries(databases, url.first));
+        }
+        entries.append(it.value());
+    }
+
+    return matchingEntries(entries, urls, "");
+}
+
+/**
+ * Filter found entries by their access settings and sort them for each URL.
+ * The entries that need a confirmation for any of the URLs are confirmed by
+ * the user at once.
+ *
+ * @param entries the found entries for each of the URLs
+ * @param urls pairs of URL and submit URL
+ * @return an array with the matching entries for each of the URLs
+ */
+QJsonArray BrowserService::matchingEntries(const QList<QList<Entry*>>& entries,
+                                           const StringPairList& urls,
+                                           const QString& realm)
+{
     const bool alwaysAllowAccess = browserSettings()->alwaysAllowAccess();
-    const QString host = QUrl(url).host();
-    const QString submitHost = QUrl(submitUrl).host();
 
     // Check entries for authorization
+    QString confirmUrl;
     QList<Entry*> pwEntriesToConfirm;
-    QList<Entry*> pwEntries;
-    for (Entry* entry : searchEntries(url, keyList)) {
-        switch (checkAccess(entry, host, submitHost, realm)) {
-        case Denied:
-            continue;
+    QMultiHash<Entry*, StringPair> confirmHosts;
+    QVector<QList<Entry*>> urlEntriesToConfirm(urls.size());
+    QVector<QList<Entry*>> urlEntries(urls.size());
+    for (int i = 0; i < urls.size(); ++i) {
+        const QString host = QUrl(urls.at(i).first).host();
+        const QString submitHost = QUrl(urls.at(i).second).host();
+
+        for (Entry* entry : entries.at(i)) {
+            switch (checkAccess(entry, host, submitHost, realm)) {
+            case Denied:
+                continue;
+
+            case Unknown:
+                if (alwaysAllowAccess) {
+                    urlEntries[i].append(entry);
+                } else {
+                    urlEntriesToConfirm[i].append(entry);
+                    if (!confirmHosts.contains(entry)) {
+                        pwEntriesToConfirm.append(entry);
+                    }
+                    confirmHosts.insert(entry, qMakePair(host, submitHost));
+                    if (confirmUrl.isEmpty()) {
+                        confirmUrl = urls.at(i).first;
+                    }
+                }
+                break;
 
-        case Unknown:
-            if (alwaysAllowAccess) {
-                pwEntries.append(entry);
-            } else {
-                pwEntriesToConfirm.append(entry);
+            case Allowed:
+                urlEntries[i].append(entry);
+                break;
             }
-            break;
-
-        case Allowed:
-            pwEntries.append(entry);
-            break;
         }
     }
 
     // Confirm entries
-    if (confirmEntries(pwEntriesToConfirm, url, host, submitHost, realm)) {
-        pwEntries.append(pwEntriesToConfirm);
-    }
-
-    if (pwEntries.isEmpty()) {
-        return QJsonArray();
+    if (confirmEntries(pwEntriesToConfirm, confirmUrl, confirmHosts, realm)) {
+        for (int i = 0; i < urls.size(); ++i) {
+            urlEntries[i].append(urlEntriesToConfirm.at(i));
+        }
     }
 
-    // Sort results
-    pwEntries = sortEntries(pwEntries, host, submitUrl);
-
-    // Fill the list
-    for (Entry* entry : pwEntries) {
-        result << prepareEntry(entry);
+    QJsonArray result;
+    for (int i = 0; i < urls.size(); ++i) {
+        QJsonArray urlResult;
+        if (!urlEntries.at(i).isEmpty()) {
+            // Sort results
+            const QString host = QUrl(urls.at(i).first).host();
+            const QList<Entry*> pwEntries = sortEntries(urlEntries[i], host, urls.at(i).second);
+
+            // Fill the list
+            for (Entry* entry : pwEntries) {
+                urlResult << prepareEntry(entry);
+            }
+        }
+        result.append(urlResult);
     }
 
     return result;
@@ -390,23 +474,16 @@ QList<Entry*> BrowserService::searchEntries(Database* db, const QString& hostnam
         return entries;
     }
 
-    for (Entry* entry : EntrySearcher().search(baseDomain(hostname), rootGroup, Qt::CaseInsensitive)) {
-        QString entryUrl = entry->url();
-        QUrl entryQUrl(entryUrl);
-        QString entryScheme = entryQUrl.scheme();
-        QUrl qUrl(url);
-
-        // Ignore entry if port or scheme defined in the URL doesn't match    
-        if ((entryQUrl.port() > 0 && entryQUrl.port() != qUrl.port()) ||
-            (browserSettings()->matchUrlScheme() && !entryScheme.isEmpty() && entryScheme.compare(qUrl.scheme()) != 0)) {
+    const QUrl qUrl(url);
+    const QList<BrowserHostIndex::Match> matches = hostIndex(db)->lookup(hostname, baseDomain(hostname));
+    for (const BrowserHostIndex::Match& match : matches) {
+        // Ignore entry if port or scheme defined in the URL doesn't match
+        if ((match.port > 0 && match.port != qUrl.port()) ||
+            (browserSettings()->matchUrlScheme() && !match.scheme.isEmpty() && match.scheme.compare(qUrl.scheme()) != 0)) {
             continue;
         }
 
-        // Filter to match hostname in URL field
-        if ((!entryUrl.isEmpty() && hostname.contains(entryUrl)) 
-            || (matchUrlScheme(entryUrl) && hostname.endsWith(entryQUrl.host()))) {
-                entries.append(entry);
-        }
+        entries.append(match.entry);
     }
 
     return entries;
@@ -414,7 +491,27 @@ QList<Entry*> BrowserService::searchEntries(Database* db, const QString& hostnam
 
 QList<Entry*> BrowserService::searchEntries(const QString& url, const StringPairList& keyList)
 {
-    // Get the list of databases to search
+    return searchEntries(searchDatabases(keyList), url);
+}
+
+QList<Entry*> BrowserService::searchEntries(const QList<Database*>& databases, const QString& url)
+{
+    // Search entries matching the hostname or one of its parent domains
+    const QString hostname = QUrl(url).host();
+    QList<Entry*> entries;
+    for (Database* db : databases) {
+        entries << searchEntries(db, hostname, url);
+    }
+
+    return entries;
+}
+
+/**
+ * Get the list of databases to search, the current one or all the databases
+ * connected with the keys of the client.
+ */
+QList<Database*> BrowserService::searchDatabases(const StringPairList& keyList)
+{
     QList<Database*> databases;
     if (browserSettings()->searchInAllDatabases()) {
         const int count = m_dbTabWidget->count();
@@ -435,16 +532,7 @@ QList<Entry*> BrowserService::searchEntries(const QString& url, const StringPair
         databases << db;
     }
 
-    // Search entries matching the hostname
-    QString hostname = QUrl(url).host();
-    QList<Entry*> entries;
-    do {
-        for (Database* db : databases) {
-            entries << searchEntries(db, hostname, url);
-        }
-    } while (entries.isEmpty() && removeFirstDomain(hostname));
-
-    return entries;
+    return databases;
 }
 
 void BrowserService::convertAttributesToCustomData(Database *currentDb)
@@ -557,10 +645,15 @@ QList<Entry*> BrowserService::sortEntries(QList<Entry*>& pwEntries, const QStrin
     return results;
 }
 
+/**
+ * Ask the user for access to entries.
+ *
+ * @param confirmHosts the pairs of host and submit host each entry is
+ *        remembered for if the user chooses so
+ */
 bool BrowserService::confirmEntries(QList<Entry*>& pwEntriesToConfirm,
                                     const QString& url,
-                                    const QString& host,
-                                    const QString& submitHost,
+                                    const QMultiHash<Entry*, StringPair>& confirmHosts,
                                     const QString& realm)
 {
     if (pwEntriesToConfirm.isEmpty() || m_dialogActive) {
@@ -577,14 +670,18 @@ bool BrowserService::confirmEntries(QList<Entry*>& pwEntriesToConfirm,
         for (Entry* entry : pwEntriesToConfirm) {
             BrowserEntryConfig config;
             config.load(entry);
-            if (res == QDialog::Accepted) {
-                config.allow(host);
-                if (!submitHost.isEmpty() && host != submitHost)
-                    config.allow(submitHost);
-            } else if (res == QDialog::Rejected) {
-                config.deny(host);
-                if (!submitHost.isEmpty() && host != submitHost) {
-                    config.deny(submitHost);
+            for (const StringPair& hosts : confirmHosts.values(entry)) {
+                const QString& host = hosts.first;
+                const QString& submitHost = hosts.second;
+                if (res == QDialog::Accepted) {
+                    config.allow(host);
+                    if (!submitHost.isEmpty() && host != submitHost)
+                        config.allow(submitHost);
+                } else if (res == QDialog::Rejected) {
+                    config.deny(host);
+                    if (!submitHost.isEmpty() && host != submitHost) {
+                        config.deny(submitHost);
+                    }
                 }
             }
             if (!realm.isEmpty()) {
@@ -685,7 +782,7 @@ int BrowserService::sortPriority(const Entry* entry,
                                  const QString& submitUrl,
                                  const QString& baseSubmitUrl) const
 {
-    QUrl url(entry->url());
+    QUrl url = entry->parsedUrl().url;
     if (url.scheme().isEmpty()) {
         url.setScheme("http");
     }
@@ -729,27 +826,14 @@ int BrowserService::sortPriority(const Entry* entry,
     return 0;
 }
 
-bool BrowserService::matchUrlScheme(const QString& url)
+BrowserHostIndex* BrowserService::hostIndex(Database* db)
 {
-    QUrl address(url);
-    return !address.scheme().isEmpty();
-}
-
-bool BrowserService::removeFirstDomain(QString& hostname)
-{
-    int pos = hostname.indexOf(".");
-    if (pos < 0) {
-        return false;
+    // the index of a deleted database is gone as well, even if its address is reused
+    QPointer<BrowserHostIndex>& index = m_hostIndexes[db];
+    if (!index) {
+        index = new BrowserHostIndex(db);
     }
-
-    // Don't remove the second-level domain if it's the only one
-    if (hostname.count(".") > 1) {
-        hostname = hostname.mid(pos + 1);
-        return !hostname.isEmpty();
-    }
-
-    // Nothing removed
-    return false;
+    return index;
 }
 
 /**
@@ -759,20 +843,7 @@ bool BrowserService::removeFirstDomain(QString& hostname)
  */
 QString BrowserService::baseDomain(const QString& url) const
 {
-    QUrl qurl = QUrl::fromUserInput(url);
-    QString hostname = qurl.host();
-
-    if (hostname.isEmpty() || !hostname.contains(qurl.topLevelDomain())) {
-        return {};
-    }
-
-    // Remove the top level domain part from the hostname, e.g. https://another.example.co.uk -> https://another.example
-    hostname.chop(qurl.topLevelDomain().length());
-    // Split the URL and select the last part, e.g. https://another.example -> example
-    QString baseDomain = hostname.split('.').last();
-    // Append the top level domain back to the URL, e.g. example -> example.co.uk
-    baseDomain.append(qurl.topLevelDomain());
-    return baseDomain;
+    return Tools::registrableDomain(QUrl::fromUserInput(url));
 }
 
 Database* BrowserService::getDatabase()
@@ -25,6 +25,8 @@
 #include <QObject>
 #include <QtCore>
 
+class BrowserHostIndex;
+
 typedef QPair<QString, QString> StringPair;
 typedef QList<StringPair> StringPairList;
 
@@ -55,6 +57,7 @@ public:
                   Database* selectedDb = nullptr);
     QList<Entry*> searchEntries(Database* db, const QString& hostname, const QString& url);
     QList<Entry*> searchEntries(const QString& url, const StringPairList& keyList);
+    QList<Entry*> searchEntries(const QList<Database*>& databases, const QString& url);
     void convertAttributesToCustomData(Database *currentDb = nullptr);
 
 public:
@@ -69,6 +72,7 @@ public slots:
                                    const QString& submitUrl,
                                    const QString& realm,
                                    const StringPairList& keyList);
+    QJsonArray findMatchingEntries(const QString& id, const StringPairList& urls, const StringPairList& keyList);
     QString storeKey(const QString& key);
     void updateEntry(const QString& id,
                      const QString& uuid,
@@ -95,19 +99,19 @@ private:
     };
 
 private:
+    QList<Database*> searchDatabases(const StringPairList& keyList);
+    QJsonArray matchingEntries(const QList<QList<Entry*>>& entries, const StringPairList& urls, const QString& realm);
     QList<Entry*> sortEntries(QList<Entry*>& pwEntries, const QString& host, const QString& submitUrl);
     bool confirmEntries(QList<Entry*>& pwEntriesToConfirm,
                         const QString& url,
-                        const QString& host,
-                        const QString& submitHost,
+                        const QMultiHash<Entry*, StringPair>& confirmHosts,
                         const QString& realm);
     QJsonObject prepareEntry(const Entry* entry);
     Access checkAccess(const Entry* entry, const QString& host, const QString& submitHost, const QString& realm);
     Group* findCreateAddEntryGroup(Database* selectedDb = nullptr);
     int
     sortPriority(const Entry* entry, const QString& host, const QString& submitUrl, const QString& baseSubmitUrl) const;
-    bool matchUrlScheme(const QString& url);
-    bool removeFirstDomain(QString& hostname);
+    BrowserHostIndex* hostIndex(Database* db);
     QString baseDomain(const QString& url) const;
     Database* getDatabase();
     Database* selectedDatabase();
@@ -120,6 +124,7 @@ private:
     bool m_dialogActive;
     bool m_bringToFrontRequested;
     QUuid m_keepassBrowserUUID;
+    QHash<const Database*, QPointer<BrowserHostIndex>> m_hostIndexes;
 };
 
 #endif // BROWSERSERVICE_H
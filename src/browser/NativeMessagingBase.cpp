@@ -19,23 +19,22 @@
 #include "NativeMessagingBase.h"
 #include <QStandardPaths>
 
-#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
-#include <sys/event.h>
-#include <sys/time.h>
-#include <sys/types.h>
-#include <unistd.h>
-#endif
+#include "core/Global.h"
 
-#ifdef Q_OS_LINUX
-#include <sys/epoll.h>
-#include <unistd.h>
-#endif
+#include <cerrno>
+#include <cstring>
 
 #ifdef Q_OS_WIN
 #include <fcntl.h>
 #include <io.h>
 #endif
 
+namespace
+{
+    const int ReadChunkSize = 64 * 1024;
+    const int LengthPrefixSize = sizeof(quint32);
+} // namespace
+
 NativeMessagingBase::NativeMessagingBase(const bool enabled)
 {
 #ifdef Q_OS_WIN
@@ -50,65 +49,92 @@ NativeMessagingBase::NativeMessagingBase(const bool enabled)
 #endif
 }
 
+/**
+ * Read the data available on stdin and handle the complete messages in it.
+ * The notifier only fires when there is data, so the read doesn't block.
+ * Partial messages stay in the buffer until the rest arrives.
+ */
 void NativeMessagingBase::newNativeMessage()
 {
-#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
-    struct kevent ev[1];
-    struct timespec ts = {5, 0};
+#ifndef Q_OS_WIN
+    const int oldSize = m_readBuffer.size();
+    m_readBuffer.resize(oldSize + ReadChunkSize);
+    const ssize_t bytesRead = ::read(fileno(stdin), m_readBuffer.data() + oldSize, ReadChunkSize);
+    m_readBuffer.resize(oldSize + qMax<int>(bytesRead, 0));
 
-    int fd = kqueue();
-    if (fd == -1) {
-        m_notifier->setEnabled(false);
+    if (bytesRead == 0 || (bytesRead < 0 && errno != EINTR)) {
+        closeNativeInput();
         return;
     }
 
-    EV_SET(ev, fileno(stdin), EVFILT_READ, EV_ADD, 0, 0, nullptr);
-    if (kevent(fd, ev, 1, nullptr, 0, &ts) == -1) {
-        m_notifier->setEnabled(false);
-        return;
-    }
+    // Take the complete messages out of the buffer before handling any of them. Handling
+    // may show a dialog whose event loop calls this again, which must only see new data.
+    QList<QByteArray> messages;
+    int consumed = 0;
+    while (m_readBuffer.size() - consumed >= LengthPrefixSize) {
+        // the length is in native byte order
+        quint32 length = 0;
+        std::memcpy(&length, m_readBuffer.constData() + consumed, LengthPrefixSize);
+        if (length == 0 || length > static_cast<quint32>(NATIVE_MSG_MAX_LENGTH)) {
+            closeNativeInput();
+            return;
+        }
+        if (static_cast<quint32>(m_readBuffer.size() - consumed - LengthPrefixSize) < length) {
+            break;
+        }
 
-    int ret = kevent(fd, NULL, 0, ev, 1, &ts);
-    if (ret < 1) {
-        m_notifier->setEnabled(false);
-        ::close(fd);
-        return;
-    }
-#elif defined(Q_OS_LINUX)
-    int fd = epoll_create(5);
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.fd = 0;
-    if (epoll_ctl(fd, EPOLL_CTL_ADD, 0, &event) != 0) {
-        m_notifier->setEnabled(false);
-        return;
+        messages.append(m_readBuffer.mid(consumed + LengthPrefixSize, static_cast<int>(length)));
+        consumed += LengthPrefixSize + static_cast<int>(length);
     }
 
-    if (epoll_wait(fd, &event, 1, 5000) < 1) {
-        m_notifier->setEnabled(false);
-        ::close(fd);
-        return;
+    // keeps the capacity of the buffer for the next messages
+    m_readBuffer.remove(0, consumed);
+
+    for (const QByteArray& message : asConst(messages)) {
+        handleNativeMessage(message);
     }
-#endif
-    readLength();
-#ifndef Q_OS_WIN
-    ::close(fd);
 #endif
 }
 
+/**
+ * Blocking reader loop for stdin, used on a separate thread on Windows where
+ * stdin can't be watched by the event loop.
+ */
 void NativeMessagingBase::readNativeMessages()
 {
 #ifdef Q_OS_WIN
-    quint32 length = 0;
-    while (m_running.load() && !std::cin.eof()) {
-        length = 0;
-        std::cin.read(reinterpret_cast<char*>(&length), 4);
-        readStdIn(length);
-        QThread::msleep(1);
+    while (m_running.load()) {
+        quint32 length = 0;
+        std::cin.read(reinterpret_cast<char*>(&length), LengthPrefixSize);
+        if (!std::cin || length == 0 || length > static_cast<quint32>(NATIVE_MSG_MAX_LENGTH)) {
+            break;
+        }
+
+        m_readBuffer.resize(static_cast<int>(length));
+        std::cin.read(m_readBuffer.data(), length);
+        if (std::cin.gcount() != static_cast<std::streamsize>(length)) {
+            // message ended prematurely
+            break;
+        }
+        handleNativeMessage(m_readBuffer);
     }
+    closeNativeInput();
 #endif
 }
 
+void NativeMessagingBase::closeNativeInput()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+    }
+    m_readBuffer.clear();
+    nativeInputClosed();
+}
+
+void NativeMessagingBase::nativeInputClosed()
+{
+}
+
 QString NativeMessagingBase::jsonToString(const QJsonObject& json) const
 {
     return QString(QJsonDocument(json).toJson(QJsonDocument::Compact));
@@ -124,11 +150,18 @@ void NativeMessagingBase::sendReply(const QJsonObject& json)
 void NativeMessagingBase::sendReply(const QString& reply)
 {
     if (!reply.isEmpty()) {
-        QByteArray bytes = reply.toUtf8();
-        uint len = bytes.size();
+        sendReply(reply.toUtf8());
+    }
+}
+
+void NativeMessagingBase::sendReply(const QByteArray& reply)
+{
+    if (!reply.isEmpty()) {
+        uint len = reply.size();
         std::cout << char(((len >> 0) & 0xFF)) << char(((len >> 8) & 0xFF)) << char(((len >> 16) & 0xFF))
                   << char(((len >> 24) & 0xFF));
-        std::cout << reply.toStdString() << std::flush;
+        std::cout.write(reply.constData(), reply.size());
+        std::cout << std::flush;
     }
 }
 
@@ -51,18 +51,23 @@ protected slots:
     void newNativeMessage();
 
 protected:
-    virtual void readLength() = 0;
-    virtual bool readStdIn(const quint32 length) = 0;
+    virtual void handleNativeMessage(const QByteArray& message) = 0;
+    virtual void nativeInputClosed();
     void readNativeMessages();
+    void closeNativeInput();
     QString jsonToString(const QJsonObject& json) const;
     void sendReply(const QJsonObject& json);
     void sendReply(const QString& reply);
+    void sendReply(const QByteArray& reply);
     QString getLocalServerPath() const;
 
 protected:
     QAtomicInteger<quint8> m_running;
     QSharedPointer<QSocketNotifier> m_notifier;
     QFuture<void> m_future;
+
+private:
+    QByteArray m_readBuffer;
 };
 
 #endif // NATIVEMESSAGINGBASE_H
@@ -18,6 +18,7 @@
 
 #include "NativeMessagingHost.h"
 #include "BrowserSettings.h"
+#include "core/Global.h"
 #include "sodium.h"
 #include <QMutexLocker>
 #include <QtNetwork>
@@ -102,44 +103,19 @@ void NativeMessagingHost::stop()
     m_socketList.clear();
     m_running.testAndSetOrdered(true, false);
     m_future.waitForFinished();
-    m_localServer->close();
-}
-
-void NativeMessagingHost::readLength()
-{
-    quint32 length = 0;
-    std::cin.read(reinterpret_cast<char*>(&length), 4);
-    if (!std::cin.eof() && length > 0) {
-        readStdIn(length);
-    } else {
-        m_notifier->setEnabled(false);
+    // the workers never wait for the GUI thread, so this can't deadlock
+    for (RequestWatcher* watcher : asConst(m_requestWatchers)) {
+        watcher->waitForFinished();
     }
+    m_pendingMessages.clear();
+    m_busySockets.clear();
+    m_localServer->close();
 }
 
-bool NativeMessagingHost::readStdIn(const quint32 length)
+void NativeMessagingHost::handleNativeMessage(const QByteArray& message)
 {
-    if (length <= 0) {
-        return false;
-    }
-
-    QByteArray arr;
-    arr.reserve(length);
-
     QMutexLocker locker(&m_mutex);
-
-    for (quint32 i = 0; i < length; ++i) {
-        int c = std::getchar();
-        if (c == EOF) {
-            // message ended prematurely, ignore it and return
-            return false;
-        }
-        arr.append(static_cast<char>(c));
-    }
-
-    if (arr.length() > 0) {
-        sendReply(m_browserClients.readResponse(arr));
-    }
-    return true;
+    sendReply(m_browserClients.readResponse(message));
 }
 
 void NativeMessagingHost::newLocalConnection()
@@ -175,12 +151,100 @@ void NativeMessagingHost::newLocalMessage()
         m_socketList.push_back(socket);
     }
 
-    QString reply = jsonToString(m_browserClients.readResponse(arr));
-    if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
-        QByteArray arr = reply.toUtf8();
-        socket->write(arr.constData(), arr.length());
+    // the messages of a connection are handled in order, different connections concurrently
+    m_pendingMessages[socket].enqueue(arr);
+    processNextMessage(socket);
+}
+
+/**
+ * Start handling the next message of a connection unless it is busy with one.
+ *
+ * A message is handled in three stages: it is parsed and decrypted on a
+ * worker thread, the action is handled on the GUI thread since it accesses
+ * the databases and may show dialogs, and the response is encrypted on a
+ * worker thread again.
+ */
+void NativeMessagingHost::processNextMessage(QLocalSocket* socket)
+{
+    if (m_busySockets.contains(socket)) {
+        return;
+    }
+
+    auto it = m_pendingMessages.find(socket);
+    if (it == m_pendingMessages.end()) {
+        return;
+    }
+    const QByteArray arr = it.value().dequeue();
+    if (it.value().isEmpty()) {
+        m_pendingMessages.erase(it);
+    }
+    m_busySockets.insert(socket);
+
+    BrowserClients* browserClients = &m_browserClients;
+    const QPointer<QLocalSocket> requestSocket(socket);
+    watchRequest(QtConcurrent::run([browserClients, requestSocket, arr]() {
+                     PendingRequest pending;
+                     pending.socket = requestSocket;
+                     pending.action = browserClients->prepareRequest(arr, pending.request);
+                     return pending;
+                 }),
+                 SLOT(requestDecrypted()));
+}
+
+void NativeMessagingHost::watchRequest(const QFuture<PendingRequest>& future, const char* slot)
+{
+    auto* watcher = new RequestWatcher(this);
+    m_requestWatchers.insert(watcher);
+    connect(watcher, SIGNAL(finished()), slot);
+    watcher->setFuture(future);
+}
+
+NativeMessagingHost::PendingRequest NativeMessagingHost::takeRequest(QObject* watcher)
+{
+    auto* requestWatcher = static_cast<RequestWatcher*>(watcher);
+    const PendingRequest pending = requestWatcher->result();
+    m_requestWatchers.remove(requestWatcher);
+    requestWatcher->deleteLater();
+    return pending;
+}
+
+void NativeMessagingHost::requestDecrypted()
+{
+    PendingRequest handled = takeRequest(sender());
+    if (!m_running.load() || !handled.socket) {
+        return;
+    }
+
+    if (handled.action) {
+        handled.action->handleRequest(handled.request);
+    }
+
+    watchRequest(QtConcurrent::run([handled]() {
+                     PendingRequest encrypted = handled;
+                     if (encrypted.action) {
+                         encrypted.action->encryptResponse(encrypted.request);
+                     }
+                     encrypted.reply = QJsonDocument(encrypted.request.response).toJson(QJsonDocument::Compact);
+                     return encrypted;
+                 }),
+                 SLOT(requestEncrypted()));
+}
+
+void NativeMessagingHost::requestEncrypted()
+{
+    const PendingRequest pending = takeRequest(sender());
+    QLocalSocket* socket = pending.socket;
+    if (!m_running.load() || !socket) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_busySockets.remove(socket);
+    if (socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
+        socket->write(pending.reply.constData(), pending.reply.length());
         socket->flush();
     }
+    processNextMessage(socket);
 }
 
 void NativeMessagingHost::sendReplyToAllClients(const QJsonObject& json)
@@ -205,6 +269,8 @@ void NativeMessagingHost::disconnectSocket()
             m_socketList.removeOne(s);
         }
     }
+    m_pendingMessages.remove(socket);
+    m_busySockets.remove(socket);
 }
 
 void NativeMessagingHost::databaseLocked()
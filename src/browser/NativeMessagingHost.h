@@ -24,12 +24,28 @@
 #include "NativeMessagingBase.h"
 #include "gui/DatabaseTabWidget.h"
 
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPointer>
+#include <QQueue>
+#include <QSet>
+
 class NativeMessagingHost : public NativeMessagingBase
 {
     Q_OBJECT
 
     typedef QList<QLocalSocket*> SocketList;
 
+    struct PendingRequest
+    {
+        QPointer<QLocalSocket> socket;
+        QSharedPointer<BrowserAction> action;
+        BrowserAction::Request request;
+        QByteArray reply;
+    };
+
+    typedef QFutureWatcher<PendingRequest> RequestWatcher;
+
 public:
     explicit NativeMessagingHost(DatabaseTabWidget* parent = nullptr, const bool enabled = false);
     ~NativeMessagingHost();
@@ -41,9 +57,11 @@ signals:
     void quit();
 
 private:
-    void readLength() override;
-    bool readStdIn(const quint32 length) override;
+    void handleNativeMessage(const QByteArray& message) override;
     void sendReplyToAllClients(const QJsonObject& json);
+    void processNextMessage(QLocalSocket* socket);
+    void watchRequest(const QFuture<PendingRequest>& future, const char* slot);
+    PendingRequest takeRequest(QObject* watcher);
 
 private slots:
     void databaseLocked();
@@ -51,6 +69,8 @@ private slots:
     void newLocalConnection();
     void newLocalMessage();
     void disconnectSocket();
+    void requestDecrypted();
+    void requestEncrypted();
 
 private:
     QMutex m_mutex;
@@ -58,6 +78,9 @@ private:
     BrowserClients m_browserClients;
     QSharedPointer<QLocalServer> m_localServer;
     SocketList m_socketList;
+    QHash<QLocalSocket*, QQueue<QByteArray>> m_pendingMessages;
+    QSet<QLocalSocket*> m_busySockets;
+    QSet<RequestWatcher*> m_requestWatchers;
 };
 
 #endif // NATIVEMESSAGINGHOST_H
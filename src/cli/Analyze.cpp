@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Analyze.h"
+
+#include <QCommandLineParser>
+#include <QStringList>
+
+#include "cli/TextStream.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/PasswordHealth.h"
+
+namespace
+{
+    QString entryPath(const Entry* entry)
+    {
+        // same format as the paths given by locate, without the root group
+        QStringList path = entry->group()->hierarchy();
+        path.removeFirst();
+        path.append(entry->title());
+        return QString("/") + path.join("/");
+    }
+} // namespace
+
+Analyze::Analyze()
+{
+    name = QString("analyze");
+    description = QObject::tr("Analyze passwords for weaknesses and problems.");
+}
+
+Analyze::~Analyze()
+{
+}
+
+int Analyze::execute(const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT, QIODevice::WriteOnly);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    QCommandLineOption keyFile(QStringList() << "k" << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    parser.addHelpOption();
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli analyze");
+        return EXIT_FAILURE;
+    }
+
+    QScopedPointer<Database> db(Database::unlockFromStdin(args.at(0), parser.value(keyFile), Utils::STDOUT, Utils::STDERR));
+    if (!db) {
+        return EXIT_FAILURE;
+    }
+
+    return printHealthReport(db.data());
+}
+
+/**
+ * Print one line for every entry with a weak, empty or reused password, or
+ * that is expired.
+ */
+int Analyze::printHealthReport(Database* database)
+{
+    TextStream out(Utils::STDOUT, QIODevice::WriteOnly);
+
+    PasswordHealth health;
+    const QList<PasswordHealth::Item> items = health.analyze(database);
+
+    int count = 0;
+    for (const PasswordHealth::Item& item : items) {
+        if (!item.hasProblems()) {
+            continue;
+        }
+
+        QStringList problems;
+        if (item.quality == PasswordHealth::Quality::Bad) {
+            problems << QObject::tr("Empty password");
+        } else if (item.quality <= PasswordHealth::Quality::Weak) {
+            problems << QObject::tr("%1 password (%2 bits)")
+                            .arg(PasswordHealth::qualityName(item.quality), QString::number(item.entropy, 'f', 2));
+        }
+        if (item.reuseCount > 1) {
+            problems << QObject::tr("Password used by %n entries", "", item.reuseCount);
+        }
+        if (item.expired) {
+            problems << QObject::tr("Expired");
+        }
+
+        out << entryPath(item.entry) << ": " << problems.join(", ") << endl;
+        ++count;
+    }
+
+    if (count == 0) {
+        out << QObject::tr("No problems found.") << endl;
+    }
+    return EXIT_SUCCESS;
+}
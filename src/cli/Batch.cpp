@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Batch.h"
+
+#include <QCommandLineParser>
+
+#include "cli/TextStream.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+
+Batch::Batch()
+{
+    name = QString("batch");
+    description = QObject::tr("Run several commands against a database unlocked once.");
+}
+
+Batch::~Batch()
+{
+}
+
+int Batch::execute(const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    QCommandLineOption keyFile(QStringList() << "k" << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    parser.addHelpOption();
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli batch");
+        return EXIT_FAILURE;
+    }
+
+    QScopedPointer<Database> db(Database::unlockFromStdin(args.at(0), parser.value(keyFile), Utils::STDOUT, Utils::STDERR));
+    if (!db) {
+        return EXIT_FAILURE;
+    }
+
+    return runCommands(db.data());
+}
+
+/**
+ * Read newline-delimited commands from STDIN and execute them against
+ * the given database until the input ends or an exit command is read.
+ * Empty lines and lines starting with # are ignored.
+ *
+ * @param database the unlocked database
+ * @return EXIT_SUCCESS if every command succeeded, EXIT_FAILURE otherwise
+ */
+int Batch::runCommands(Database* database)
+{
+    TextStream err(Utils::STDERR, QIODevice::WriteOnly);
+
+    int exitCode = EXIT_SUCCESS;
+    bool atEnd = false;
+    while (true) {
+        const QString line = Utils::readLine(Utils::STDIN, &atEnd).trimmed();
+        if (atEnd) {
+            break;
+        }
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QStringList arguments = Utils::splitCommandString(line);
+        if (arguments.isEmpty()) {
+            continue;
+        }
+
+        const QString& commandName = arguments.first();
+        if (commandName == "exit" || commandName == "quit") {
+            break;
+        }
+
+        Command* command = Command::getCommand(commandName);
+        if (!command) {
+            err << QObject::tr("Invalid command %1.").arg(commandName) << endl;
+            exitCode = EXIT_FAILURE;
+            continue;
+        }
+
+        if (command->executeWithDatabase(database, arguments) != EXIT_SUCCESS) {
+            exitCode = EXIT_FAILURE;
+        }
+    }
+
+    return exitCode;
+}
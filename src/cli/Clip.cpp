@@ -30,6 +30,18 @@
 #include "core/Entry.h"
 #include "core/Group.h"
 
+namespace
+{
+    /**
+     * Add the options shared by the standalone and the interactive form of the command.
+     */
+    void addClipOptions(QCommandLineParser& parser)
+    {
+        parser.addOption(QCommandLineOption(QStringList() << "t" << "totp",
+                                            QObject::tr("Copy the current TOTP to the clipboard.")));
+    }
+} // namespace
+
 Clip::Clip()
 {
     name = QString("clip");
@@ -51,9 +63,7 @@ int Clip::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    QCommandLineOption totp(QStringList() << "t"  << "totp",
-                            QObject::tr("Copy the current TOTP to the clipboard."));
-    parser.addOption(totp);
+    addClipOptions(parser);
     parser.addPositionalArgument("entry", QObject::tr("Path of the entry to clip.", "clip = copy to clipboard"));
     parser.addPositionalArgument("timeout",
                                  QObject::tr("Timeout in seconds before clearing the clipboard."), "[timeout]");
@@ -71,7 +81,33 @@ int Clip::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    return clipEntry(db, args.at(1), args.value(2), parser.isSet(totp));
+    return clipEntry(db, args.at(1), args.value(2), parser.isSet("totp"));
+}
+
+int Clip::executeWithDatabase(Database* database, const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT);
+    TextStream err(Utils::STDERR);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    addClipOptions(parser);
+    parser.addPositionalArgument("entry", QObject::tr("Path of the entry to clip.", "clip = copy to clipboard"));
+    parser.addPositionalArgument("timeout",
+                                 QObject::tr("Timeout in seconds before clearing the clipboard."), "[timeout]");
+    parser.addHelpOption();
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << endl;
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (parser.isSet("help") || (args.size() != 1 && args.size() != 2)) {
+        out << parser.helpText().replace("keepassxc-cli", name);
+        return EXIT_FAILURE;
+    }
+
+    return clipEntry(database, args.at(0), args.value(1), parser.isSet("totp"));
 }
 
 int Clip::clipEntry(Database* database, const QString& entryPath, const QString& timeout, bool clipTotp)
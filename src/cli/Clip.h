@@ -26,6 +26,7 @@ public:
     Clip();
     ~Clip();
     int execute(const QStringList& arguments) override;
+    int executeWithDatabase(Database* database, const QStringList& arguments) override;
     int clipEntry(Database* database, const QString& entryPath, const QString& timeout, bool clipTotp);
 };
 
@@ -23,6 +23,8 @@
 #include "Command.h"
 
 #include "Add.h"
+#include "Analyze.h"
+#include "Batch.h"
 #include "Clip.h"
 #include "Diceware.h"
 #include "Edit.h"
@@ -33,7 +35,10 @@
 #include "Locate.h"
 #include "Merge.h"
 #include "Remove.h"
+#include "Serve.h"
 #include "Show.h"
+#include "TextStream.h"
+#include "Utils.h"
 
 QMap<QString, Command*> commands;
 
@@ -41,6 +46,25 @@ Command::~Command()
 {
 }
 
+/**
+ * Execute the command against an already unlocked database, as done by
+ * the batch mode. The arguments must not contain the database path or
+ * key file options.
+ *
+ * @param database the unlocked database
+ * @param arguments the command name followed by its arguments
+ * @return the exit code of the command
+ */
+int Command::executeWithDatabase(Database* database, const QStringList& arguments)
+{
+    Q_UNUSED(database);
+    Q_UNUSED(arguments);
+
+    TextStream err(Utils::STDERR, QIODevice::WriteOnly);
+    err << QObject::tr("Command %1 is not available in batch mode.").arg(name) << endl;
+    return EXIT_FAILURE;
+}
+
 QString Command::getDescriptionLine()
 {
 
@@ -57,6 +81,8 @@ void populateCommands()
 {
     if (commands.isEmpty()) {
         commands.insert(QString("add"), new Add());
+        commands.insert(QString("analyze"), new Analyze());
+        commands.insert(QString("batch"), new Batch());
         commands.insert(QString("clip"), new Clip());
         commands.insert(QString("diceware"), new Diceware());
         commands.insert(QString("edit"), new Edit());
@@ -67,6 +93,7 @@ void populateCommands()
         commands.insert(QString("ls"), new List());
         commands.insert(QString("merge"), new Merge());
         commands.insert(QString("rm"), new Remove());
+        commands.insert(QString("serve"), new Serve());
         commands.insert(QString("show"), new Show());
     }
 }
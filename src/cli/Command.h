@@ -30,6 +30,7 @@ class Command
 public:
     virtual ~Command();
     virtual int execute(const QStringList& arguments) = 0;
+    virtual int executeWithDatabase(Database* database, const QStringList& arguments);
     QString name;
     QString description;
     QString getDescriptionLine();
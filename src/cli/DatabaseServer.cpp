@@ -0,0 +1,339 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseServer.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QtEndian>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/InactivityTimer.h"
+
+namespace
+{
+    const quint32 MAX_MESSAGE_LENGTH = 1024 * 1024;
+
+    QJsonObject errorReply(const QString& error)
+    {
+        QJsonObject reply;
+        reply["success"] = false;
+        reply["error"] = error;
+        return reply;
+    }
+
+    QJsonObject successReply()
+    {
+        QJsonObject reply;
+        reply["success"] = true;
+        return reply;
+    }
+
+    void listGroupContents(const Group* group, const QString& path, bool recursive, QJsonArray& entries, QJsonArray& groups)
+    {
+        for (const Entry* entry : group->entries()) {
+            entries.append(path + entry->title());
+        }
+
+        for (const Group* child : group->children()) {
+            const QString childPath = path + child->name() + "/";
+            groups.append(childPath);
+            if (recursive) {
+                listGroupContents(child, childPath, recursive, entries, groups);
+            }
+        }
+    }
+} // namespace
+
+DatabaseServer::DatabaseServer(Database* db, QObject* parent)
+    : QObject(parent)
+    , m_db(db)
+    , m_server(new QLocalServer(this))
+    , m_inactivityTimer(new InactivityTimer(this))
+    , m_lockTimeout(0)
+{
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, SIGNAL(newConnection()), SLOT(newConnection()));
+    connect(m_inactivityTimer, SIGNAL(inactivityDetected()), SLOT(lock()));
+}
+
+DatabaseServer::~DatabaseServer()
+{
+}
+
+/**
+ * Start answering requests on the given local socket path. A stale socket
+ * file is replaced, but a path another server is listening on is not.
+ *
+ * @param serverPath name or path of the local socket
+ * @return true on success
+ */
+bool DatabaseServer::listen(const QString& serverPath)
+{
+    if (!m_db) {
+        m_errorString = tr("The database is locked.");
+        return false;
+    }
+
+    QLocalSocket probe;
+    probe.connectToServer(serverPath);
+    if (probe.waitForConnected(100)) {
+        probe.disconnectFromServer();
+        m_errorString = tr("Another server is already listening on %1.").arg(serverPath);
+        return false;
+    }
+
+    QLocalServer::removeServer(serverPath);
+    if (!m_server->listen(serverPath)) {
+        m_errorString = m_server->errorString();
+        return false;
+    }
+
+    if (m_lockTimeout > 0) {
+        m_inactivityTimer->activate();
+    }
+    return true;
+}
+
+QString DatabaseServer::serverPath() const
+{
+    return m_server->fullServerName();
+}
+
+QString DatabaseServer::errorString() const
+{
+    return m_errorString;
+}
+
+/**
+ * Lock the database once no request was received for the given time.
+ *
+ * @param timeout inactivity timeout in milliseconds, 0 to never lock
+ */
+void DatabaseServer::setLockTimeout(int timeout)
+{
+    m_lockTimeout = timeout;
+    if (m_lockTimeout > 0) {
+        m_inactivityTimer->setInactivityTimeout(m_lockTimeout);
+        if (m_server->isListening()) {
+            m_inactivityTimer->activate();
+        }
+    } else {
+        m_inactivityTimer->deactivate();
+    }
+}
+
+QString DatabaseServer::defaultServerPath()
+{
+    const QString serverPath = "/kpxc_cli_server";
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+    // Use XDG_RUNTIME_DIR instead of /tmp if it's available
+    QString path = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    return path.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverPath : path + serverPath;
+#else // Q_OS_MACOS, Q_OS_WIN and others
+    return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverPath;
+#endif
+}
+
+/**
+ * Close the socket, disconnect all clients and release the database.
+ */
+void DatabaseServer::lock()
+{
+    if (!m_db) {
+        return;
+    }
+
+    m_inactivityTimer->deactivate();
+    const QList<QLocalSocket*> sockets = m_server->findChildren<QLocalSocket*>();
+    for (QLocalSocket* socket : sockets) {
+        socket->disconnectFromServer();
+        socket->deleteLater();
+    }
+    m_server->close();
+    m_db.reset();
+
+    emit locked();
+}
+
+QJsonObject DatabaseServer::handleRequest(const QJsonObject& request)
+{
+    if (!m_db) {
+        return errorReply(tr("The database is locked."));
+    }
+
+    const QString action = request.value("action").toString();
+    if (action == "show") {
+        return showEntry(request);
+    } else if (action == "attribute") {
+        return showAttribute(request);
+    } else if (action == "locate") {
+        return locateEntries(request);
+    } else if (action == "list") {
+        return listGroup(request);
+    } else if (action == "lock") {
+        // reply before the connection is closed
+        QMetaObject::invokeMethod(this, "lock", Qt::QueuedConnection);
+        return successReply();
+    }
+
+    return errorReply(tr("Unknown action %1.").arg(action));
+}
+
+void DatabaseServer::newConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, SIGNAL(readyRead()), SLOT(readRequests()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+void DatabaseServer::readRequests()
+{
+    auto* socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    if (m_lockTimeout > 0 && m_db) {
+        m_inactivityTimer->activate();
+    }
+
+    while (socket->bytesAvailable() >= 4) {
+        const QByteArray header = socket->peek(4);
+        const quint32 length = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(header.constData()));
+        if (length > MAX_MESSAGE_LENGTH) {
+            socket->abort();
+            return;
+        }
+        if (socket->bytesAvailable() < qint64(length) + 4) {
+            return;
+        }
+
+        socket->read(4);
+        const QJsonDocument doc = QJsonDocument::fromJson(socket->read(length));
+        sendReply(socket, doc.isObject() ? handleRequest(doc.object()) : errorReply(tr("Invalid request.")));
+    }
+}
+
+QJsonObject DatabaseServer::showEntry(const QJsonObject& request) const
+{
+    const QString entryPath = request.value("entry").toString();
+    Entry* entry = m_db->rootGroup()->findEntryByPath(entryPath);
+    if (!entry) {
+        return errorReply(tr("Could not find entry with path %1.").arg(entryPath));
+    }
+
+    const bool showTotp = request.value("totp").toBool();
+    if (showTotp && !entry->hasTotp()) {
+        return errorReply(tr("Entry with path %1 has no TOTP set up.").arg(entryPath));
+    }
+
+    QStringList attributes = request.value("attributes").toVariant().toStringList();
+    if (attributes.isEmpty() && !showTotp) {
+        attributes = EntryAttributes::DefaultAttributes;
+    }
+
+    QJsonObject values;
+    for (const QString& attribute : asConst(attributes)) {
+        if (!entry->attributes()->contains(attribute)) {
+            return errorReply(tr("Unknown attribute %1.").arg(attribute));
+        }
+        values.insert(attribute, entry->resolveMultiplePlaceholders(entry->attributes()->value(attribute)));
+    }
+
+    QJsonObject reply = successReply();
+    reply["attributes"] = values;
+    if (showTotp) {
+        reply["totp"] = entry->totp();
+    }
+    return reply;
+}
+
+QJsonObject DatabaseServer::showAttribute(const QJsonObject& request) const
+{
+    const QString entryPath = request.value("entry").toString();
+    Entry* entry = m_db->rootGroup()->findEntryByPath(entryPath);
+    if (!entry) {
+        return errorReply(tr("Could not find entry with path %1.").arg(entryPath));
+    }
+
+    const QString attribute = request.value("attribute").toString();
+    if (!entry->attributes()->contains(attribute)) {
+        return errorReply(tr("Unknown attribute %1.").arg(attribute));
+    }
+
+    QJsonObject reply = successReply();
+    reply["value"] = entry->resolveMultiplePlaceholders(entry->attributes()->value(attribute));
+    return reply;
+}
+
+QJsonObject DatabaseServer::locateEntries(const QJsonObject& request) const
+{
+    const QString term = request.value("term").toString();
+    QJsonObject reply = successReply();
+    reply["entries"] = QJsonArray::fromStringList(m_db->rootGroup()->locate(term));
+    return reply;
+}
+
+QJsonObject DatabaseServer::listGroup(const QJsonObject& request) const
+{
+    QString groupPath = request.value("group").toString();
+    const Group* group = m_db->rootGroup();
+    if (!groupPath.isEmpty() && groupPath != "/") {
+        group = m_db->rootGroup()->findGroupByPath(groupPath);
+        if (!group) {
+            return errorReply(tr("Cannot find group %1.").arg(groupPath));
+        }
+    }
+
+    if (!groupPath.startsWith("/")) {
+        groupPath.prepend("/");
+    }
+    if (!groupPath.endsWith("/")) {
+        groupPath.append("/");
+    }
+
+    QJsonArray entries;
+    QJsonArray groups;
+    listGroupContents(group, groupPath, request.value("recursive").toBool(), entries, groups);
+
+    QJsonObject reply = successReply();
+    reply["entries"] = entries;
+    reply["groups"] = groups;
+    return reply;
+}
+
+void DatabaseServer::sendReply(QLocalSocket* socket, const QJsonObject& reply)
+{
+    if (socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+
+    const QByteArray message = QJsonDocument(reply).toJson(QJsonDocument::Compact);
+    uchar header[4];
+    qToLittleEndian<quint32>(static_cast<quint32>(message.size()), header);
+    socket->write(reinterpret_cast<const char*>(header), 4);
+    socket->write(message);
+    socket->flush();
+}
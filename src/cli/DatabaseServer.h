@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASESERVER_H
+#define KEEPASSXC_DATABASESERVER_H
+
+#include <QJsonObject>
+#include <QObject>
+#include <QScopedPointer>
+
+class Database;
+class InactivityTimer;
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * Answers lookups on an unlocked database over a user-only local socket.
+ *
+ * Every request and reply is a compact JSON object prefixed with its length
+ * as a 32-bit little-endian integer, like native messaging. A request names
+ * an "action" and its arguments:
+ *
+ *   {"action": "show", "entry": "/path", "attributes": ["Title"], "totp": false}
+ *   {"action": "attribute", "entry": "/path", "attribute": "Password"}
+ *   {"action": "locate", "term": "search term"}
+ *   {"action": "list", "group": "/path", "recursive": false}
+ *   {"action": "lock"}
+ *
+ * Every reply contains a boolean "success" and either the requested data or
+ * an "error" message.
+ */
+class DatabaseServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseServer(Database* db, QObject* parent = nullptr);
+    ~DatabaseServer();
+
+    bool listen(const QString& serverPath);
+    QString serverPath() const;
+    QString errorString() const;
+    void setLockTimeout(int timeout);
+    QJsonObject handleRequest(const QJsonObject& request);
+
+    static QString defaultServerPath();
+
+signals:
+    void locked();
+
+public slots:
+    void lock();
+
+private slots:
+    void newConnection();
+    void readRequests();
+
+private:
+    QJsonObject showEntry(const QJsonObject& request) const;
+    QJsonObject showAttribute(const QJsonObject& request) const;
+    QJsonObject locateEntries(const QJsonObject& request) const;
+    QJsonObject listGroup(const QJsonObject& request) const;
+    void sendReply(QLocalSocket* socket, const QJsonObject& reply);
+
+    QScopedPointer<Database> m_db;
+    QLocalServer* m_server;
+    InactivityTimer* m_inactivityTimer;
+    int m_lockTimeout;
+    QString m_errorString;
+};
+
+#endif // KEEPASSXC_DATABASESERVER_H
@@ -28,6 +28,18 @@
 #include "core/Entry.h"
 #include "core/Group.h"
 
+namespace
+{
+    /**
+     * Add the options shared by the standalone and the interactive form of the command.
+     */
+    void addListOptions(QCommandLineParser& parser)
+    {
+        parser.addOption(QCommandLineOption(QStringList() << "R" << "recursive",
+                                            QObject::tr("Recursively list the elements of the group.")));
+    }
+} // namespace
+
 List::List()
 {
     name = QString("ls");
@@ -50,9 +62,7 @@ int List::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    QCommandLineOption recursiveOption(QStringList() << "R" << "recursive",
-                                       QObject::tr("Recursively list the elements of the group."));
-    parser.addOption(recursiveOption);
+    addListOptions(parser);
     parser.addHelpOption();
     parser.process(arguments);
 
@@ -62,7 +72,7 @@ int List::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    bool recursive = parser.isSet(recursiveOption);
+    bool recursive = parser.isSet("recursive");
 
     QScopedPointer<Database> db(Database::unlockFromStdin(args.at(0), parser.value(keyFile), Utils::STDOUT, Utils::STDERR));
     if (!db) {
@@ -75,6 +85,30 @@ int List::execute(const QStringList& arguments)
     return listGroup(db.data(), recursive);
 }
 
+int List::executeWithDatabase(Database* database, const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT);
+    TextStream err(Utils::STDERR);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    parser.addPositionalArgument("group", QObject::tr("Path of the group to list. Default is /"), "[group]");
+    addListOptions(parser);
+    parser.addHelpOption();
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << endl;
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (parser.isSet("help") || args.size() > 1) {
+        out << parser.helpText().replace("keepassxc-cli", name);
+        return EXIT_FAILURE;
+    }
+
+    return listGroup(database, parser.isSet("recursive"), args.value(0));
+}
+
 int List::listGroup(Database* database, bool recursive, const QString& groupPath)
 {
     TextStream out(Utils::STDOUT, QIODevice::WriteOnly);
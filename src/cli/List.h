@@ -26,6 +26,7 @@ public:
     List();
     ~List();
     int execute(const QStringList& arguments) override;
+    int executeWithDatabase(Database* database, const QStringList& arguments) override;
     int listGroup(Database* database, bool recursive, const QString& groupPath = {});
 };
 
@@ -69,6 +69,29 @@ int Locate::execute(const QStringList& arguments)
     return locateEntry(db.data(), args.at(1));
 }
 
+int Locate::executeWithDatabase(Database* database, const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT, QIODevice::WriteOnly);
+    TextStream err(Utils::STDERR, QIODevice::WriteOnly);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    parser.addPositionalArgument("term", QObject::tr("Search term."));
+    parser.addHelpOption();
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << endl;
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (parser.isSet("help") || args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", name);
+        return EXIT_FAILURE;
+    }
+
+    return locateEntry(database, args.at(0));
+}
+
 int Locate::locateEntry(Database* database, const QString& searchTerm)
 {
     TextStream out(Utils::STDOUT, QIODevice::WriteOnly);
@@ -26,6 +26,7 @@ public:
     Locate();
     ~Locate();
     int execute(const QStringList& arguments) override;
+    int executeWithDatabase(Database* database, const QStringList& arguments) override;
     int locateEntry(Database* database, const QString& searchTerm);
 };
 
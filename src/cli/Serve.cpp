@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <climits>
+#include <cstdlib>
+#include <stdio.h>
+
+#include "Serve.h"
+
+#include <QCommandLineParser>
+#include <QEventLoop>
+
+#include "cli/DatabaseServer.h"
+#include "cli/TextStream.h"
+#include "cli/Utils.h"
+#include "core/Database.h"
+
+Serve::Serve()
+{
+    name = QString("serve");
+    description = QObject::tr("Answer requests on a database over a local socket.");
+}
+
+Serve::~Serve()
+{
+}
+
+int Serve::execute(const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT);
+    TextStream err(Utils::STDERR);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    parser.addPositionalArgument("database", QObject::tr("Path of the database."));
+    QCommandLineOption keyFile(QStringList() << "k" << "key-file",
+                               QObject::tr("Key file of the database."),
+                               QObject::tr("path"));
+    parser.addOption(keyFile);
+    QCommandLineOption socket(QStringList() << "s" << "socket",
+                              QObject::tr("Path of the local socket. Default is %1").arg(DatabaseServer::defaultServerPath()),
+                              QObject::tr("path"));
+    parser.addOption(socket);
+    QCommandLineOption lockTimeout(QStringList() << "l" << "lock-timeout",
+                                   QObject::tr("Lock the database after this many seconds without requests. "
+                                               "0 never locks it. Default is 300"),
+                                   QObject::tr("seconds"));
+    parser.addOption(lockTimeout);
+    parser.addHelpOption();
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", "keepassxc-cli serve");
+        return EXIT_FAILURE;
+    }
+
+    int timeout = 300;
+    if (parser.isSet(lockTimeout)) {
+        bool ok;
+        timeout = parser.value(lockTimeout).toInt(&ok);
+        // The timeout is handed to a timer in milliseconds
+        if (!ok || timeout < 0 || timeout > INT_MAX / 1000) {
+            err << QObject::tr("Invalid timeout value %1.").arg(parser.value(lockTimeout)) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Database* db = Database::unlockFromStdin(args.at(0), parser.value(keyFile), Utils::STDOUT, Utils::STDERR);
+    if (!db) {
+        return EXIT_FAILURE;
+    }
+
+    DatabaseServer server(db);
+    server.setLockTimeout(timeout * 1000);
+    const QString serverPath = parser.isSet(socket) ? parser.value(socket) : DatabaseServer::defaultServerPath();
+    if (!server.listen(serverPath)) {
+        err << QObject::tr("Failed to listen on %1: %2").arg(serverPath, server.errorString()) << endl;
+        return EXIT_FAILURE;
+    }
+
+    out << QObject::tr("Listening on %1").arg(server.serverPath()) << endl;
+
+    QEventLoop loop;
+    QObject::connect(&server, SIGNAL(locked()), &loop, SLOT(quit()));
+    loop.exec();
+
+    out << QObject::tr("Database locked.") << endl;
+    return EXIT_SUCCESS;
+}
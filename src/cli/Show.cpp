@@ -29,6 +29,25 @@
 #include "core/Global.h"
 #include "Utils.h"
 
+namespace
+{
+    /**
+     * Add the options shared by the standalone and the interactive form of the command.
+     */
+    void addShowOptions(QCommandLineParser& parser)
+    {
+        parser.addOption(QCommandLineOption(QStringList() << "t" << "totp",
+                                            QObject::tr("Show the entry's current TOTP.")));
+        parser.addOption(QCommandLineOption(
+            QStringList() << "a" << "attributes",
+            QObject::tr(
+                "Names of the attributes to show. "
+                "This option can be specified more than once, with each attribute shown one-per-line in the given order. "
+                "If no attributes are specified, a summary of the default attributes is given."),
+            QObject::tr("attribute")));
+    }
+} // namespace
+
 Show::Show()
 {
     name = QString("show");
@@ -50,17 +69,7 @@ int Show::execute(const QStringList& arguments)
                                QObject::tr("Key file of the database."),
                                QObject::tr("path"));
     parser.addOption(keyFile);
-    QCommandLineOption totp(QStringList() << "t"  << "totp",
-                            QObject::tr("Show the entry's current TOTP."));
-    parser.addOption(totp);
-    QCommandLineOption attributes(
-        QStringList() << "a" << "attributes",
-        QObject::tr(
-            "Names of the attributes to show. "
-            "This option can be specified more than once, with each attribute shown one-per-line in the given order. "
-            "If no attributes are specified, a summary of the default attributes is given."),
-        QObject::tr("attribute"));
-    parser.addOption(attributes);
+    addShowOptions(parser);
     parser.addPositionalArgument("entry", QObject::tr("Name of the entry to show."));
     parser.addHelpOption();
     parser.process(arguments);
@@ -76,7 +85,31 @@ int Show::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
-    return showEntry(db.data(), parser.values(attributes), parser.isSet(totp), args.at(1));
+    return showEntry(db.data(), parser.values("attributes"), parser.isSet("totp"), args.at(1));
+}
+
+int Show::executeWithDatabase(Database* database, const QStringList& arguments)
+{
+    TextStream out(Utils::STDOUT);
+    TextStream err(Utils::STDERR);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(description);
+    addShowOptions(parser);
+    parser.addPositionalArgument("entry", QObject::tr("Name of the entry to show."));
+    parser.addHelpOption();
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << endl;
+        return EXIT_FAILURE;
+    }
+
+    const QStringList args = parser.positionalArguments();
+    if (parser.isSet("help") || args.size() != 1) {
+        out << parser.helpText().replace("keepassxc-cli", name);
+        return EXIT_FAILURE;
+    }
+
+    return showEntry(database, parser.values("attributes"), parser.isSet("totp"), args.at(0));
 }
 
 int Show::showEntry(Database* database, QStringList attributes, bool showTotp, const QString& entryPath)
@@ -26,6 +26,7 @@ public:
     Show();
     ~Show();
     int execute(const QStringList& arguments) override;
+    int executeWithDatabase(Database* database, const QStringList& arguments) override;
     int showEntry(Database* database, QStringList attributes, bool showTotp, const QString& entryPath);
 };
 
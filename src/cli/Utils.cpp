@@ -26,6 +26,8 @@
 
 #include <QProcess>
 
+#include <cstdio>
+
 namespace Utils
 {
 /**
@@ -107,16 +109,95 @@ QString getPassword()
         return password;
     }
 
-    TextStream in(STDIN, QIODevice::ReadOnly);
-
     setStdinEcho(false);
-    QString line = in.readLine();
+    QString line = readLine(STDIN);
     setStdinEcho(true);
     out << endl;
 
     return line;
 }
 
+/**
+ * Read a single line from a file handle.
+ *
+ * Unlike QTextStream, this does not buffer any input past the end of the
+ * line, so that the remaining input can still be read from the same handle,
+ * e.g. the commands following the password in batch mode.
+ *
+ * @param fileHandle handle to read from
+ * @param atEnd set to true if the end of the input was reached before reading anything
+ * @return the line without its line terminator
+ */
+QString readLine(FILE* fileHandle, bool* atEnd)
+{
+    QByteArray line;
+    int c;
+    while ((c = std::fgetc(fileHandle)) != EOF && c != '\n') {
+        line.append(static_cast<char>(c));
+    }
+    if (line.endsWith('\r')) {
+        line.chop(1);
+    }
+
+    if (atEnd) {
+        *atEnd = (c == EOF && line.isEmpty());
+    }
+
+    TextStream in(line);
+    return in.readAll();
+}
+
+/**
+ * Split a command line into its arguments.
+ *
+ * Arguments are separated by whitespace. Single or double quotes group
+ * words into one argument and a backslash escapes the next character.
+ *
+ * @param command the command line to split
+ * @return the list of arguments
+ */
+QStringList splitCommandString(const QString& command)
+{
+    QStringList arguments;
+    QString argument;
+    bool inArgument = false;
+    QChar quote;
+    bool escaped = false;
+
+    for (const QChar& c : command) {
+        if (escaped) {
+            argument.append(c);
+            escaped = false;
+        } else if (c == '\\' && quote != '\'') {
+            escaped = true;
+            inArgument = true;
+        } else if (!quote.isNull()) {
+            if (c == quote) {
+                quote = QChar();
+            } else {
+                argument.append(c);
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            inArgument = true;
+        } else if (c.isSpace()) {
+            if (inArgument) {
+                arguments.append(argument);
+                argument.clear();
+                inArgument = false;
+            }
+        } else {
+            argument.append(c);
+            inArgument = true;
+        }
+    }
+
+    if (inArgument) {
+        arguments.append(argument);
+    }
+    return arguments;
+}
+
 /**
  * A valid and running event loop is needed to use the global QClipboard,
  * so we need to use this from the CLI.
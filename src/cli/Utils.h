@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_UTILS_H
 #define KEEPASSXC_UTILS_H
 
+#include <QStringList>
 #include <QtCore/qglobal.h>
 #include "cli/TextStream.h"
 
@@ -29,6 +30,8 @@ extern FILE* STDIN;
 
 void setStdinEcho(bool enable);
 QString getPassword();
+QString readLine(FILE* fileHandle, bool* atEnd = nullptr);
+QStringList splitCommandString(const QString& command);
 int clipText(const QString& text);
 
 namespace Test
@@ -40,12 +40,16 @@
 #include "keys/PasswordKey.h"
 
 QHash<QUuid, Database*> Database::m_uuidMap;
+QMutex Database::m_uuidMapMutex;
 
 Database::Database()
     : m_metadata(new Metadata(this))
     , m_rootGroup(nullptr)
     , m_timer(new QTimer(this))
     , m_emitModified(false)
+    , m_bulkUpdateDepth(0)
+    , m_bulkModifiedImmediate(false)
+    , m_bulkMarkedAsModified(false)
     , m_uuid(QUuid::createUuid())
 {
     m_data.cipher = KeePass2::CIPHER_AES256;
@@ -61,7 +65,11 @@ Database::Database()
     rootGroup()->setUuid(QUuid::createUuid());
     m_timer->setSingleShot(true);
 
-    m_uuidMap.insert(m_uuid, this);
+    {
+        // databases may be constructed by worker threads, see DatabaseOpenScheduler
+        QMutexLocker locker(&m_uuidMapMutex);
+        m_uuidMap.insert(m_uuid, this);
+    }
 
     connect(m_metadata, SIGNAL(modified()), this, SIGNAL(modifiedImmediate()));
     connect(m_metadata, SIGNAL(nameTextChanged()), this, SIGNAL(nameTextChanged()));
@@ -71,6 +79,7 @@ Database::Database()
 
 Database::~Database()
 {
+    QMutexLocker locker(&m_uuidMapMutex);
     m_uuidMap.remove(m_uuid);
 }
 
@@ -425,6 +434,7 @@ void Database::recycleGroup(Group* group)
 void Database::emptyRecycleBin()
 {
     if (m_metadata->recycleBinEnabled() && m_metadata->recycleBin()) {
+        beginBulkUpdate();
         // destroying direct entries of the recycle bin
         QList<Entry*> subEntries = m_metadata->recycleBin()->entries();
         for (Entry* entry : subEntries) {
@@ -435,6 +445,7 @@ void Database::emptyRecycleBin()
         for (Group* group : subGroups) {
             delete group;
         }
+        endBulkUpdate();
     }
 }
 
@@ -449,9 +460,56 @@ void Database::setEmitModified(bool value)
 
 void Database::markAsModified()
 {
+    if (m_bulkUpdateDepth > 0) {
+        m_bulkMarkedAsModified = true;
+        return;
+    }
     emit modified();
 }
 
+/**
+ * Start a bulk update of the database, e.g. a merge or an import.
+ *
+ * Until the matching call to endBulkUpdate() the models are expected to ignore
+ * the notifications about single groups and entries and to reset once the
+ * update is finished. The modified signals are coalesced and emitted once at
+ * the end. Bulk updates can be nested, only the outermost pair takes effect.
+ */
+void Database::beginBulkUpdate()
+{
+    if (m_bulkUpdateDepth++ > 0) {
+        return;
+    }
+
+    m_bulkModifiedImmediate = false;
+    m_bulkMarkedAsModified = false;
+    emit bulkUpdateStarted();
+}
+
+void Database::endBulkUpdate()
+{
+    Q_ASSERT(m_bulkUpdateDepth > 0);
+    if (m_bulkUpdateDepth <= 0 || --m_bulkUpdateDepth > 0) {
+        return;
+    }
+
+    emit bulkUpdateFinished();
+
+    if (m_bulkMarkedAsModified) {
+        m_timer->stop();
+        emit modified();
+    } else if (m_bulkModifiedImmediate) {
+        emit modifiedImmediate();
+    }
+    m_bulkModifiedImmediate = false;
+    m_bulkMarkedAsModified = false;
+}
+
+bool Database::isBulkUpdating() const
+{
+    return m_bulkUpdateDepth > 0;
+}
+
 const QUuid& Database::uuid()
 {
     return m_uuid;
@@ -459,11 +517,17 @@ const QUuid& Database::uuid()
 
 Database* Database::databaseByUuid(const QUuid& uuid)
 {
+    QMutexLocker locker(&m_uuidMapMutex);
     return m_uuidMap.value(uuid, 0);
 }
 
 void Database::startModifiedTimer()
 {
+    if (m_bulkUpdateDepth > 0) {
+        m_bulkModifiedImmediate = true;
+        return;
+    }
+
     if (!m_emitModified) {
         return;
     }
@@ -21,6 +21,7 @@
 
 #include <QDateTime>
 #include <QHash>
+#include <QMutex>
 #include <QObject>
 
 #include "crypto/kdf/Kdf.h"
@@ -121,6 +122,9 @@ public:
     void emptyRecycleBin();
     void setEmitModified(bool value);
     void markAsModified();
+    void beginBulkUpdate();
+    void endBulkUpdate();
+    bool isBulkUpdating() const;
     QString saveToFile(const QString& filePath, bool atomic = true, bool backup = false);
 
     /**
@@ -145,6 +149,8 @@ signals:
     void nameTextChanged();
     void modified();
     void modifiedImmediate();
+    void bulkUpdateStarted();
+    void bulkUpdateFinished();
 
 private slots:
     void startModifiedTimer();
@@ -164,11 +170,15 @@ private:
     QTimer* m_timer;
     DatabaseData m_data;
     bool m_emitModified;
+    int m_bulkUpdateDepth;
+    bool m_bulkModifiedImmediate;
+    bool m_bulkMarkedAsModified;
 
     QString m_filePath;
 
     QUuid m_uuid;
     static QHash<QUuid, Database*> m_uuidMap;
+    static QMutex m_uuidMapMutex;
 };
 
 #endif // KEEPASSX_DATABASE_H
@@ -0,0 +1,250 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseOpenScheduler.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QThread>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "crypto/kdf/Argon2Kdf.h"
+#include "format/KeePass2.h"
+#include "format/KeePass2Reader.h"
+#include "keys/CompositeKey.h"
+
+namespace
+{
+    // rough ratio between the in-memory size of a parsed database and its file size
+    const quint64 PARSED_SIZE_FACTOR = 4;
+
+    /**
+     * Estimate the peak memory needed for opening a database in KiB,
+     * which is dominated by the Argon2 memory cost if applicable.
+     */
+    quint64 estimateMemoryCost(const QString& filePath)
+    {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return 0;
+        }
+
+        quint64 cost = static_cast<quint64>(file.size()) * PARSED_SIZE_FACTOR / 1024;
+
+        KeePass2Reader reader;
+        QSharedPointer<Kdf> kdf = reader.readKdf(&file);
+        if (kdf && kdf->uuid() == KeePass2::KDF_ARGON2) {
+            cost += kdf.staticCast<Argon2Kdf>()->memory();
+        }
+        return cost;
+    }
+
+    /**
+     * Move a database with all its groups and entries to another thread.
+     * History items have no QObject parent, so they are not part of the
+     * database's object tree and need to be moved separately.
+     */
+    void moveDatabaseToThread(Database* db, QThread* thread)
+    {
+        db->moveToThread(thread);
+        const QList<Entry*> entries = db->rootGroup()->entriesRecursive(true);
+        for (Entry* entry : entries) {
+            if (!entry->parent()) {
+                entry->moveToThread(thread);
+            }
+        }
+    }
+} // namespace
+
+struct DatabaseOpenScheduler::Job
+{
+    QString filePath;
+    QSharedPointer<const CompositeKey> key;
+    quint64 memoryCost;
+    Database* db;
+    QString errorString;
+};
+
+class DatabaseOpenScheduler::Task : public QRunnable
+{
+public:
+    Task(DatabaseOpenScheduler* scheduler, int id, QSharedPointer<Job> job)
+        : m_scheduler(scheduler)
+        , m_targetThread(scheduler->thread())
+        , m_id(id)
+        , m_job(std::move(job))
+    {
+    }
+
+    void run() override
+    {
+        KeePass2Reader reader;
+        Database* db = reader.readDatabase(m_job->filePath, m_job->key);
+        if (db && !reader.hasError()) {
+            // hand the database over to the receiving thread
+            moveDatabaseToThread(db, m_targetThread);
+            m_job->db = db;
+        } else {
+            delete db;
+            m_job->errorString = reader.errorString();
+        }
+
+        QMetaObject::invokeMethod(m_scheduler, "jobFinished", Qt::QueuedConnection, Q_ARG(int, m_id));
+    }
+
+private:
+    DatabaseOpenScheduler* const m_scheduler;
+    QThread* const m_targetThread;
+    const int m_id;
+    const QSharedPointer<Job> m_job;
+};
+
+DatabaseOpenScheduler::DatabaseOpenScheduler(QObject* parent)
+    : QObject(parent)
+    , m_memoryBudget(1024 * 1024)
+    , m_memoryInUse(0)
+    , m_nextId(0)
+{
+}
+
+DatabaseOpenScheduler::~DatabaseOpenScheduler()
+{
+    // tasks reference this scheduler, wait for them before it goes away
+    m_threadPool.waitForDone();
+
+    // finished databases that were never delivered
+    for (const auto& job : asConst(m_running)) {
+        delete job->db;
+    }
+}
+
+int DatabaseOpenScheduler::maxThreadCount() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+/**
+ * @param count maximum number of databases opened at the same time
+ */
+void DatabaseOpenScheduler::setMaxThreadCount(int count)
+{
+    m_threadPool.setMaxThreadCount(qMax(1, count));
+    schedule();
+}
+
+quint64 DatabaseOpenScheduler::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+/**
+ * @param kibibytes memory all running jobs may use together
+ */
+void DatabaseOpenScheduler::setMemoryBudget(quint64 kibibytes)
+{
+    m_memoryBudget = kibibytes;
+    schedule();
+}
+
+/**
+ * Queue a database for opening. Either databaseOpened() or
+ * databaseOpenFailed() will be emitted once it has been processed.
+ *
+ * @param filePath database file
+ * @param key database key
+ */
+void DatabaseOpenScheduler::open(const QString& filePath, QSharedPointer<const CompositeKey> key)
+{
+    auto job = QSharedPointer<Job>::create();
+    job->filePath = filePath;
+    job->key = std::move(key);
+    job->memoryCost = estimateMemoryCost(filePath);
+    job->db = nullptr;
+
+    m_queue.append(job);
+    schedule();
+}
+
+/**
+ * @return true if the given file is queued or currently being opened
+ */
+bool DatabaseOpenScheduler::isPending(const QString& filePath) const
+{
+    for (const auto& job : m_queue) {
+        if (job->filePath == filePath) {
+            return true;
+        }
+    }
+    for (const auto& job : m_running) {
+        if (job->filePath == filePath) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DatabaseOpenScheduler::isIdle() const
+{
+    return m_queue.isEmpty() && m_running.isEmpty();
+}
+
+/**
+ * Start queued jobs in order as long as there are free threads and their
+ * memory cost fits into the remaining budget.
+ */
+void DatabaseOpenScheduler::schedule()
+{
+    auto it = m_queue.begin();
+    while (it != m_queue.end() && m_running.size() < m_threadPool.maxThreadCount()) {
+        const QSharedPointer<Job> job = *it;
+        bool fits = m_memoryInUse + job->memoryCost <= m_memoryBudget;
+        if (!fits && !m_running.isEmpty()) {
+            // smaller jobs further back may still fit
+            ++it;
+            continue;
+        }
+
+        it = m_queue.erase(it);
+        int id = m_nextId++;
+        m_running.insert(id, job);
+        m_memoryInUse += job->memoryCost;
+        m_threadPool.start(new Task(this, id, job));
+    }
+}
+
+void DatabaseOpenScheduler::jobFinished(int id)
+{
+    QSharedPointer<Job> job = m_running.take(id);
+    Q_ASSERT(job);
+    if (!job) {
+        return;
+    }
+
+    m_memoryInUse -= job->memoryCost;
+    schedule();
+
+    if (job->db) {
+        emit databaseOpened(job->filePath, job->db);
+    } else {
+        emit databaseOpenFailed(job->filePath, job->errorString);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_DATABASEOPENSCHEDULER_H
+#define KEEPASSXC_DATABASEOPENSCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+class CompositeKey;
+class Database;
+
+/**
+ * Open several databases concurrently.
+ *
+ * Key transformation and parsing of each database run on a bounded pool of
+ * worker threads. Since the memory cost of Argon2 adds up when several
+ * databases are unlocked at once, a job is only started if its estimated
+ * memory usage fits into the remaining memory budget. A job that exceeds
+ * the budget on its own is run when no other job is active.
+ *
+ * The opened databases are moved to the thread the scheduler lives in and
+ * delivered in the order they complete.
+ */
+class DatabaseOpenScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseOpenScheduler(QObject* parent = nullptr);
+    ~DatabaseOpenScheduler() override;
+
+    int maxThreadCount() const;
+    void setMaxThreadCount(int count);
+    quint64 memoryBudget() const;
+    void setMemoryBudget(quint64 kibibytes);
+
+    void open(const QString& filePath, QSharedPointer<const CompositeKey> key);
+    bool isPending(const QString& filePath) const;
+    bool isIdle() const;
+
+signals:
+    /**
+     * Emitted for every successfully opened database. The receiver takes ownership of db.
+     */
+    void databaseOpened(const QString& filePath, Database* db);
+    void databaseOpenFailed(const QString& filePath, const QString& errorString);
+
+private slots:
+    void jobFinished(int id);
+
+private:
+    struct Job;
+    class Task;
+
+    void schedule();
+
+    QThreadPool m_threadPool;
+    quint64 m_memoryBudget;
+    quint64 m_memoryInUse;
+    int m_nextId;
+    QList<QSharedPointer<Job>> m_queue;
+    QHash<int, QSharedPointer<Job>> m_running;
+};
+
+#endif // KEEPASSXC_DATABASEOPENSCHEDULER_H
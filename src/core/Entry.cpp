@@ -24,11 +24,15 @@
 #include "core/DatabaseIcons.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/Tools.h"
+#include "crypto/CryptoHash.h"
 #include "totp/totp.h"
 
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
 #include <QRegularExpression>
+#include <algorithm>
 #include <utility>
 
 const int Entry::DefaultIconNumber = 0;
@@ -44,11 +48,18 @@ Entry::Entry()
     , m_tmpHistoryItem(nullptr)
     , m_modifiedSinceBegin(false)
     , m_updateTimeinfo(true)
+    , m_parsedUrlValid(false)
 {
     m_data.iconNumber = DefaultIconNumber;
     m_data.autoTypeEnabled = true;
     m_data.autoTypeObfuscation = 0;
 
+    // invalidate the digest before anyone is notified about the modification
+    connect(m_attributes, SIGNAL(modified()), SLOT(invalidateContentDigest()));
+    connect(m_attachments, SIGNAL(modified()), SLOT(invalidateContentDigest()));
+    connect(m_autoTypeAssociations, SIGNAL(modified()), SLOT(invalidateContentDigest()));
+    connect(m_customData, SIGNAL(modified()), SLOT(invalidateContentDigest()));
+    connect(m_attributes, SIGNAL(modified()), SLOT(invalidateParsedUrl()));
     connect(m_attributes, SIGNAL(modified()), SLOT(updateTotp()));
     connect(m_attributes, SIGNAL(modified()), this, SIGNAL(modified()));
     connect(m_attributes, SIGNAL(defaultKeyModified()), SLOT(emitDataChanged()));
@@ -78,6 +89,7 @@ template <class T> inline bool Entry::set(T& property, const T& value)
 {
     if (property != value) {
         property = value;
+        m_contentDigest.clear();
         emit modified();
         return true;
     }
@@ -281,8 +293,39 @@ QString Entry::url() const
 
 QString Entry::webUrl() const
 {
-    QString url = resolveMultiplePlaceholders(m_attributes->value(EntryAttributes::URLKey));
-    return resolveUrl(url);
+    const QString url = m_attributes->value(EntryAttributes::URLKey);
+    if (!url.contains('{')) {
+        // nothing to resolve
+        return parsedUrl().webUrl;
+    }
+    return resolveUrl(resolveMultiplePlaceholders(url));
+}
+
+/**
+ * The parsed URL of the entry, cached until the URL changes.
+ */
+EntryUrl Entry::parsedUrl() const
+{
+    if (m_parsedUrlValid) {
+        return m_parsedUrl;
+    }
+
+    const QString url = m_attributes->value(EntryAttributes::URLKey);
+    m_parsedUrl.url = QUrl(url);
+    m_parsedUrl.scheme = m_parsedUrl.url.scheme();
+    QUrl hostUrl = m_parsedUrl.url;
+    if (hostUrl.host().isEmpty()) {
+        m_parsedUrl.scheme.clear();
+        if (!url.isEmpty()) {
+            hostUrl = QUrl::fromUserInput(url);
+        }
+    }
+    m_parsedUrl.host = hostUrl.host().toLower();
+    m_parsedUrl.port = hostUrl.port();
+    m_parsedUrl.registrableDomain = Tools::registrableDomain(hostUrl);
+    m_parsedUrl.webUrl = resolveUrl(url);
+    m_parsedUrlValid = true;
+    return m_parsedUrl;
 }
 
 QString Entry::displayUrl() const
@@ -360,7 +403,7 @@ bool Entry::hasTotp() const
 QString Entry::totp() const
 {
     if (hasTotp()) {
-        return Totp::generateTotp(m_data.totpSettings);
+        return Totp::generateTotp(*totpContext());
     }
     return {};
 }
@@ -395,6 +438,22 @@ QSharedPointer<Totp::Settings> Entry::totpSettings() const
     return m_data.totpSettings;
 }
 
+/**
+ * The decoded TOTP key of the entry, prepared for generating codes. It is
+ * cached until the TOTP settings change.
+ *
+ * @return the context or null if the entry has no TOTP
+ */
+QSharedPointer<Totp::Context> Entry::totpContext() const
+{
+    if (!hasTotp()) {
+        m_totpContext.reset();
+    } else if (!m_totpContext || m_totpContext->settings != m_data.totpSettings) {
+        m_totpContext = Totp::createContext(m_data.totpSettings);
+    }
+    return m_totpContext;
+}
+
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
@@ -408,6 +467,7 @@ void Entry::setIcon(int iconNumber)
     if (m_data.iconNumber != iconNumber || !m_data.customIcon.isNull()) {
         m_data.iconNumber = iconNumber;
         m_data.customIcon = QUuid();
+        m_contentDigest.clear();
 
         emit modified();
         emitDataChanged();
@@ -421,6 +481,7 @@ void Entry::setIcon(const QUuid& uuid)
     if (m_data.customIcon != uuid) {
         m_data.customIcon = uuid;
         m_data.iconNumber = 0;
+        m_contentDigest.clear();
 
         emit modified();
         emitDataChanged();
@@ -616,16 +677,8 @@ bool Entry::equals(const Entry* other, CompareItemOptions options) const
     if (!m_data.equals(other->m_data, options)) {
         return false;
     }
-    if (*m_customData != *other->m_customData) {
-        return false;
-    }
-    if (*m_attributes != *other->m_attributes) {
-        return false;
-    }
-    if (*m_attachments != *other->m_attachments) {
-        return false;
-    }
-    if (*m_autoTypeAssociations != *other->m_autoTypeAssociations) {
+    // compares custom data, attributes, attachments and auto-type associations
+    if (contentDigest() != other->contentDigest()) {
         return false;
     }
     if (!options.testFlag(CompareItemIgnoreHistory)) {
@@ -641,6 +694,68 @@ bool Entry::equals(const Entry* other, CompareItemOptions options) const
     return true;
 }
 
+/**
+ * SHA-256 digest of the content of this entry: attributes, attachments,
+ * auto-type settings, custom data, icon, colors, override URL and tags.
+ * The UUID, times, history and location are not included.
+ *
+ * The digest is cached until the entry is modified, so entries with the
+ * same content can be found with a single comparison.
+ */
+QByteArray Entry::contentDigest() const
+{
+    if (!m_contentDigest.isEmpty()) {
+        return m_contentDigest;
+    }
+
+    // the digests are stored in the merge base, so they must not depend on the Qt version
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << m_data.iconNumber << m_data.customIcon << m_data.foregroundColor << m_data.backgroundColor
+           << m_data.overrideUrl << m_data.tags << m_data.autoTypeEnabled << m_data.autoTypeObfuscation
+           << m_data.defaultAutoTypeSequence;
+
+    const QList<QString> attributeKeys = m_attributes->keys();
+    stream << attributeKeys.size();
+    for (const QString& key : attributeKeys) {
+        stream << key << m_attributes->value(key) << m_attributes->isProtected(key);
+    }
+
+    const QList<QString> attachmentKeys = m_attachments->keys();
+    stream << attachmentKeys.size();
+    for (const QString& key : attachmentKeys) {
+        stream << key << m_attachments->value(key);
+    }
+
+    const QList<AutoTypeAssociations::Association> associations = m_autoTypeAssociations->getAll();
+    stream << associations.size();
+    for (const AutoTypeAssociations::Association& association : associations) {
+        stream << association.window << association.sequence;
+    }
+
+    // the custom data is hashed, sort it to be independent of the insertion order and hash seed
+    QList<QString> customDataKeys = m_customData->keys();
+    std::sort(customDataKeys.begin(), customDataKeys.end());
+    stream << customDataKeys.size();
+    for (const QString& key : customDataKeys) {
+        stream << key << m_customData->value(key);
+    }
+
+    m_contentDigest = CryptoHash::hash(data, CryptoHash::Sha256);
+    return m_contentDigest;
+}
+
+void Entry::invalidateContentDigest()
+{
+    m_contentDigest.clear();
+}
+
+void Entry::invalidateParsedUrl()
+{
+    m_parsedUrlValid = false;
+}
+
 Entry* Entry::clone(CloneFlags flags) const
 {
     Entry* entry = new Entry();
@@ -678,6 +793,11 @@ Entry* Entry::clone(CloneFlags flags) const
     }
     entry->setUpdateTimeinfo(true);
 
+    if (!(flags & (CloneUserAsRef | ClonePassAsRef))) {
+        // the content is unchanged, spare the clone from hashing it again
+        entry->m_contentDigest = m_contentDigest;
+    }
+
     if (flags & CloneResetTimeInfo) {
         QDateTime now = Clock::currentDateTimeUtc();
         entry->m_data.timeInfo.setCreationTime(now);
@@ -696,6 +816,7 @@ void Entry::copyDataFrom(const Entry* other)
 {
     setUpdateTimeinfo(false);
     m_data = other->m_data;
+    m_contentDigest.clear();
     m_customData->copyDataFrom(other->m_customData);
     m_attributes->copyDataFrom(other->m_attributes);
     m_attachments->copyDataFrom(other->m_attachments);
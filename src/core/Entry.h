@@ -37,6 +37,7 @@
 class Database;
 class Group;
 namespace Totp {
+    struct Context;
     struct Settings;
 }
 
@@ -71,6 +72,22 @@ struct EntryData
     bool equals(const EntryData& other, CompareItemOptions options) const;
 };
 
+/**
+ * The URL of an entry parsed for matching. Placeholders are not resolved.
+ */
+struct EntryUrl
+{
+    QUrl url;
+    // empty if the URL has no host, like example.com without a scheme
+    QString scheme;
+    // lower case, URLs without a scheme are parsed as user input
+    QString host;
+    int port;
+    QString registrableDomain;
+    // the result of Entry::resolveUrl()
+    QString webUrl;
+};
+
 class Entry : public QObject
 {
     Q_OBJECT
@@ -100,12 +117,14 @@ public:
     QString title() const;
     QString url() const;
     QString webUrl() const;
+    EntryUrl parsedUrl() const;
     QString displayUrl() const;
     QString username() const;
     QString password() const;
     QString notes() const;
     QString totp() const;
     QSharedPointer<Totp::Settings> totpSettings() const;
+    QSharedPointer<Totp::Context> totpContext() const;
 
     bool hasTotp() const;
     bool isExpired() const;
@@ -149,6 +168,7 @@ public:
     void truncateHistory();
 
     bool equals(const Entry* other, CompareItemOptions options = CompareItemDefault) const;
+    QByteArray contentDigest() const;
 
     enum CloneFlag
     {
@@ -230,6 +250,8 @@ private slots:
     void updateTimeinfo();
     void updateModifiedSinceBegin();
     void updateTotp();
+    void invalidateContentDigest();
+    void invalidateParsedUrl();
 
 private:
     QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
@@ -253,6 +275,10 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+    mutable QByteArray m_contentDigest;
+    mutable EntryUrl m_parsedUrl;
+    mutable bool m_parsedUrlValid;
+    mutable QSharedPointer<Totp::Context> m_totpContext;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -35,6 +35,7 @@ Entry::CloneFlags Group::DefaultEntryCloneFlags =
 
 Group::Group()
     : m_customData(new CustomData(this))
+    , m_indexInParent(-1)
     , m_updateTimeinfo(true)
 {
     m_data.iconNumber = DefaultIconNumber;
@@ -348,6 +349,11 @@ void Group::setExpanded(bool expanded)
 {
     if (m_data.isExpanded != expanded) {
         m_data.isExpanded = expanded;
+        // groups outside of a database are still being read, possibly on a worker
+        // thread, so they must not touch the shared config and have nobody to notify
+        if (!m_db) {
+            return;
+        }
         if (config()->get("IgnoreGroupExpansion").toBool()) {
             updateTimeinfo();
             return;
@@ -424,7 +430,7 @@ void Group::setParent(Group* parent, int index)
         }
     }
 
-    if (m_parent == parent && parent->children().indexOf(this) == index) {
+    if (m_parent == parent && m_indexInParent == index) {
         return;
     }
 
@@ -447,13 +453,22 @@ void Group::setParent(Group* parent, int index)
         emit aboutToAdd(this, index);
         Q_ASSERT(index <= parent->m_children.size());
         parent->m_children.insert(index, this);
+        parent->updateChildIndexes(index);
     } else {
         emit aboutToMove(this, parent, index);
-        m_parent->m_children.removeAll(this);
+        const int oldIndex = m_indexInParent;
+        Group* oldParent = m_parent;
+        oldParent->m_children.removeAt(oldIndex);
         m_parent = parent;
         QObject::setParent(parent);
         Q_ASSERT(index <= parent->m_children.size());
         parent->m_children.insert(index, this);
+        if (oldParent == parent) {
+            parent->updateChildIndexes(qMin(oldIndex, index));
+        } else {
+            oldParent->updateChildIndexes(oldIndex);
+            parent->updateChildIndexes(index);
+        }
     }
 
     if (m_updateTimeinfo) {
@@ -482,6 +497,17 @@ void Group::setParent(Database* db)
     QObject::setParent(db);
 }
 
+/**
+ * Position of this group among the children of its parent, -1 for groups
+ * without a parent. The position is cached, so this is a constant time
+ * lookup for the group model.
+ */
+int Group::indexInParent() const
+{
+    Q_ASSERT(!m_parent || m_parent->m_children.value(m_indexInParent) == this);
+    return m_parent ? m_indexInParent : -1;
+}
+
 QStringList Group::hierarchy() const
 {
     QStringList hierarchy;
@@ -868,12 +894,21 @@ void Group::cleanupParent()
 {
     if (m_parent) {
         emit aboutToRemove(this);
-        m_parent->m_children.removeAll(this);
+        m_parent->m_children.removeAt(m_indexInParent);
+        m_parent->updateChildIndexes(m_indexInParent);
+        m_indexInParent = -1;
         emit modified();
         emit removed();
     }
 }
 
+void Group::updateChildIndexes(int from)
+{
+    for (int i = from; i < m_children.size(); ++i) {
+        m_children[i]->m_indexInParent = i;
+    }
+}
+
 void Group::recCreateDelObjects()
 {
     if (m_db) {
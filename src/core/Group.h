@@ -141,6 +141,7 @@ public:
     Group* parentGroup();
     const Group* parentGroup() const;
     void setParent(Group* parent, int index = -1);
+    int indexInParent() const;
     QStringList hierarchy() const;
 
     Database* database();
@@ -188,6 +189,7 @@ private:
 
     void recSetDatabase(Database* db);
     void cleanupParent();
+    void updateChildIndexes(int from);
     void recCreateDelObjects();
 
     Entry* findEntryByPathRecursive(const QString& entryPath, const QString& basePath);
@@ -203,6 +205,8 @@ private:
     QPointer<CustomData> m_customData;
 
     QPointer<Group> m_parent;
+    // position in m_parent->m_children, kept up to date by the parent
+    int m_indexInParent;
 
     bool m_updateTimeinfo;
 
@@ -22,8 +22,65 @@
 #include "core/Entry.h"
 #include "core/Metadata.h"
 
+#include <QDataStream>
+#include <QtConcurrent>
+#include <algorithm>
+
+const QString Merger::BaseManifestKey = QStringLiteral("KPXC_MERGE_BASE");
+
+namespace
+{
+    const quint32 BASE_MANIFEST_SIGNATURE = 0x4b50584d; // "KPXM"
+    const quint32 BASE_MANIFEST_VERSION = 1;
+    // a prefix of the content digest is enough to notice changes and keeps the manifest compact
+    const int BASE_MANIFEST_DIGEST_SIZE = 8;
+
+    qint64 serializedTime(const QDateTime& time)
+    {
+        return Clock::serialized(time).toMSecsSinceEpoch();
+    }
+
+    int groupDepth(const Group* group)
+    {
+        int depth = 0;
+        for (const Group* parent = group->parentGroup(); parent; parent = parent->parentGroup()) {
+            ++depth;
+        }
+        return depth;
+    }
+
+    // delete an entry without touching the modification time of its parent group
+    void deleteEntry(Entry* entry)
+    {
+        Group* parentGroup = entry->group();
+        const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
+        if (parentGroup) {
+            parentGroup->setUpdateTimeinfo(false);
+        }
+        delete entry;
+        if (parentGroup) {
+            parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
+        }
+    }
+
+    // delete a group without touching the modification time of its parent group
+    void deleteGroup(Group* group)
+    {
+        Group* parentGroup = group->parentGroup();
+        const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
+        if (parentGroup) {
+            parentGroup->setUpdateTimeinfo(false);
+        }
+        delete group;
+        if (parentGroup) {
+            parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
+        }
+    }
+} // namespace
+
 Merger::Merger(const Database* sourceDb, Database* targetDb)
     : m_mode(Group::Default)
+    , m_concurrentPlanning(false)
 {
     if (!sourceDb || !targetDb) {
         Q_ASSERT(sourceDb && targetDb);
@@ -36,6 +93,7 @@ Merger::Merger(const Database* sourceDb, Database* targetDb)
 
 Merger::Merger(const Group* sourceGroup, Group* targetGroup)
     : m_mode(Group::Default)
+    , m_concurrentPlanning(false)
 {
     if (!sourceGroup || !targetGroup) {
         Q_ASSERT(sourceGroup && targetGroup);
@@ -60,10 +118,135 @@ void Merger::resetForcedMergeMode()
     m_mode = Group::Default;
 }
 
+/**
+ * Enable the three-way merge against a base manifest created with
+ * createBaseManifest(). The base lists entry versions the target database
+ * has already incorporated, e.g. the state of the database file when it
+ * was last loaded or merged. Source entries still matching their base
+ * version are skipped instead of being compared with and merged into the
+ * target. Every source entry is still visited, and the content digest of
+ * those whose times match the base is computed, so the merge remains linear
+ * in the size of the source; only the comparison and merge work scales
+ * with the number of entries changed since the base.
+ *
+ * @param manifest serialized base manifest, an empty manifest disables the three-way merge
+ * @return false if the manifest is invalid, in which case a regular merge is done
+ */
+bool Merger::setBaseManifest(const QByteArray& manifest)
+{
+    m_base.clear();
+    if (manifest.isEmpty()) {
+        return true;
+    }
+
+    QDataStream stream(manifest);
+    quint32 signature;
+    quint32 version;
+    quint32 count;
+    stream >> signature >> version >> count;
+    if (stream.status() != QDataStream::Ok || signature != BASE_MANIFEST_SIGNATURE
+        || version != BASE_MANIFEST_VERSION) {
+        return false;
+    }
+
+    const int recordSize = 16 + BASE_MANIFEST_DIGEST_SIZE + 2 * static_cast<int>(sizeof(qint64));
+    if (static_cast<qint64>(count) * recordSize > stream.device()->bytesAvailable()) {
+        return false;
+    }
+
+    QHash<QUuid, BaseItem> base;
+    base.reserve(static_cast<int>(count));
+    QByteArray uuid(16, '\0');
+    QByteArray digest(BASE_MANIFEST_DIGEST_SIZE, '\0');
+    for (quint32 i = 0; i < count; ++i) {
+        BaseItem item;
+        stream.readRawData(uuid.data(), uuid.size());
+        stream.readRawData(digest.data(), digest.size());
+        stream >> item.lastModificationTime >> item.locationChanged;
+        item.digest = digest;
+        base.insert(QUuid::fromRfc4122(uuid), item);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    m_base = base;
+    return true;
+}
+
+/**
+ * Compare the entries of both databases on worker threads before merging.
+ */
+void Merger::setConcurrentPlanning(bool enabled)
+{
+    m_concurrentPlanning = enabled;
+}
+
+/**
+ * Create a compact manifest of the UUIDs, content digests and modification
+ * times of all entries in a database, to be used as base of a later
+ * three-way merge. The manifest takes 40 bytes per entry and computing it
+ * hashes every entry that has no cached digest yet.
+ */
+QByteArray Merger::createBaseManifest(const Database* db)
+{
+    const QList<Entry*> entries = db->rootGroup()->entriesRecursive(false);
+
+    QByteArray manifest;
+    QDataStream stream(&manifest, QIODevice::WriteOnly);
+    stream << BASE_MANIFEST_SIGNATURE << BASE_MANIFEST_VERSION << static_cast<quint32>(entries.size());
+    for (const Entry* entry : entries) {
+        const QByteArray uuid = entry->uuid().toRfc4122();
+        stream.writeRawData(uuid.constData(), uuid.size());
+        stream.writeRawData(entry->contentDigest().constData(), BASE_MANIFEST_DIGEST_SIZE);
+        stream << serializedTime(entry->timeInfo().lastModificationTime())
+               << serializedTime(entry->timeInfo().locationChanged());
+    }
+    return manifest;
+}
+
+/**
+ * @return the base manifest stored in the custom data of the database, if any
+ */
+QByteArray Merger::storedBaseManifest(const Database* db)
+{
+    return QByteArray::fromBase64(db->metadata()->customData()->value(BaseManifestKey).toLatin1());
+}
+
+/**
+ * Store the manifest of the current state of the database in its custom
+ * data, so it is saved encrypted with the database and can serve as the
+ * base of its next three-way merge. It is not kept in a separate file because
+ * the digests would then be exposed unencrypted. Base64 encoded, it grows the
+ * database by about 54 bytes per entry, which is synchronized to every client
+ * of the database file.
+ *
+ * @return true if the stored manifest changed
+ */
+bool Merger::storeBaseManifest(Database* db)
+{
+    const QString manifest = QString::fromLatin1(createBaseManifest(db).toBase64());
+    if (db->metadata()->customData()->value(BaseManifestKey) == manifest) {
+        return false;
+    }
+    db->metadata()->customData()->set(BaseManifestKey, manifest);
+    return true;
+}
+
 bool Merger::merge()
 {
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
+    indexTargetItems();
+    if (m_concurrentPlanning) {
+        planConcurrently();
+    }
+
+    // apply all changes in one batch so models reset once instead of per item
+    Database* targetDb = m_context.m_targetDb;
+    targetDb->beginBulkUpdate();
+
     ChangeList changes;
     changes << mergeGroup(m_context);
     changes << mergeDeletions(m_context);
@@ -71,12 +254,114 @@ bool Merger::merge()
 
     // qDebug("Merged %s", qPrintable(changes.join("\n\t")));
 
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+    m_unchangedEntries.clear();
+
     // At this point we have a list of changes we may want to show the user
     if (!changes.isEmpty()) {
-        m_context.m_targetDb->markAsModified();
-        return true;
+        targetDb->markAsModified();
+    }
+    targetDb->endBulkUpdate();
+    return !changes.isEmpty();
+}
+
+/**
+ * Index all entries and groups of the target database by UUID once, so that
+ * matching every source item is a constant time lookup instead of a walk
+ * over the whole target tree.
+ */
+void Merger::indexTargetItems()
+{
+    m_targetEntries.clear();
+    m_targetGroups.clear();
+
+    // keep the first match of duplicate UUIDs like findEntryByUuid and findGroupByUuid
+    const QList<Entry*> entries = m_context.m_targetRootGroup->entriesRecursive(false);
+    m_targetEntries.reserve(entries.size());
+    for (Entry* entry : entries) {
+        if (!m_targetEntries.contains(entry->uuid())) {
+            m_targetEntries.insert(entry->uuid(), entry);
+        }
+    }
+
+    const QList<Group*> groups = m_context.m_targetRootGroup->groupsRecursive(true);
+    m_targetGroups.reserve(groups.size());
+    for (Group* group : groups) {
+        if (!m_targetGroups.contains(group->uuid())) {
+            m_targetGroups.insert(group->uuid(), group);
+        }
+    }
+}
+
+/**
+ * Find the source entries that need no merge on worker threads before
+ * changing the target. Since every source group is planned on its own,
+ * large databases with many groups are compared in parallel. Only the
+ * entries that actually changed are then merged on the thread owning the
+ * target database.
+ *
+ * Comparing entries reads their lazily cached content digests. These are
+ * computed up front, with every entry handled by exactly one worker, so the
+ * planning itself only reads the entries even if an entry is reached from
+ * several groups, e.g. for duplicate UUIDs.
+ */
+void Merger::planConcurrently()
+{
+    m_unchangedEntries.clear();
+
+    const QList<const Group*> sourceGroups = m_context.m_sourceGroup->groupsRecursive(true);
+    QVector<GroupPlan> plans;
+    plans.reserve(sourceGroups.size());
+    QSet<const Entry*> comparedEntries;
+    for (const Group* sourceGroup : sourceGroups) {
+        plans.append(GroupPlan{sourceGroup, {}});
+        for (const Entry* sourceEntry : sourceGroup->entries()) {
+            const Entry* targetEntry = m_targetEntries.value(sourceEntry->uuid());
+            if (!targetEntry) {
+                continue;
+            }
+            for (const Entry* entry : {sourceEntry, targetEntry}) {
+                comparedEntries.insert(entry);
+                for (const Entry* historyItem : entry->historyItems()) {
+                    comparedEntries.insert(historyItem);
+                }
+            }
+        }
+    }
+
+    QVector<const Entry*> digestEntries;
+    digestEntries.reserve(comparedEntries.size());
+    for (const Entry* entry : asConst(comparedEntries)) {
+        digestEntries.append(entry);
+    }
+    QtConcurrent::blockingMap(digestEntries, [](const Entry* entry) { entry->contentDigest(); });
+
+    QtConcurrent::blockingMap(plans, [this](GroupPlan& plan) { planGroup(plan); });
+
+    for (const GroupPlan& plan : asConst(plans)) {
+        for (const Entry* entry : plan.unchangedEntries) {
+            m_unchangedEntries.insert(entry);
+        }
+    }
+}
+
+/**
+ * Collect the entries of a single source group that are identical to their
+ * target entry. Runs on a worker thread and must not modify any entry.
+ */
+void Merger::planGroup(GroupPlan& plan) const
+{
+    for (const Entry* sourceEntry : plan.sourceGroup->entries()) {
+        const Entry* targetEntry = m_targetEntries.value(sourceEntry->uuid());
+        if (!targetEntry) {
+            continue;
+        }
+        // identical entries are neither relocated nor changed by the conflict resolution
+        if (isUnchangedSinceBase(sourceEntry) || targetEntry->equals(sourceEntry, CompareItemIgnoreMilliseconds)) {
+            plan.unchangedEntries.append(sourceEntry);
+        }
     }
-    return false;
 }
 
 Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
@@ -85,12 +370,20 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
     // merge entries
     const QList<Entry*> sourceEntries = context.m_sourceGroup->entries();
     for (Entry* sourceEntry : sourceEntries) {
-        Entry* targetEntry = context.m_targetRootGroup->findEntryByUuid(sourceEntry->uuid());
+        if (m_unchangedEntries.contains(sourceEntry)) {
+            continue;
+        }
+        Entry* targetEntry = m_targetEntries.value(sourceEntry->uuid());
+        if (targetEntry && isUnchangedSinceBase(sourceEntry)) {
+            // the target already contains this version or a newer one
+            continue;
+        }
         if (!targetEntry) {
             changes << tr("Creating missing %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
             // This entry does not exist at all. Create it.
             targetEntry = sourceEntry->clone(Entry::CloneIncludeHistory);
             moveEntry(targetEntry, context.m_targetGroup);
+            m_targetEntries.insert(targetEntry->uuid(), targetEntry);
         } else {
             // Entry is already present in the database. Update it.
             const bool locationChanged = targetEntry->timeInfo().locationChanged() < sourceEntry->timeInfo().locationChanged();
@@ -105,11 +398,12 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
     // merge groups recursively
     const QList<Group*> sourceChildGroups = context.m_sourceGroup->children();
     for (Group* sourceChildGroup : sourceChildGroups) {
-        Group* targetChildGroup = context.m_targetRootGroup->findGroupByUuid(sourceChildGroup->uuid());
+        Group* targetChildGroup = m_targetGroups.value(sourceChildGroup->uuid());
         if (!targetChildGroup) {
             changes << tr("Creating missing %1 [%2]").arg(sourceChildGroup->name(), sourceChildGroup->uuidToHex());
             targetChildGroup = sourceChildGroup->clone(Entry::CloneNoFlags, Group::CloneNoFlags);
             moveGroup(targetChildGroup, context.m_targetGroup);
+            m_targetGroups.insert(targetChildGroup->uuid(), targetChildGroup);
             TimeInfo timeinfo = targetChildGroup->timeInfo();
             timeinfo.setLocationChanged(sourceChildGroup->timeInfo().locationChanged());
             targetChildGroup->setTimeInfo(timeinfo);
@@ -162,6 +456,24 @@ Merger::ChangeList Merger::resolveGroupConflict(const MergeContext& context, con
     return changes;
 }
 
+bool Merger::isUnchangedSinceBase(const Entry* sourceEntry) const
+{
+    if (m_base.isEmpty()) {
+        return false;
+    }
+
+    const auto item = m_base.constFind(sourceEntry->uuid());
+    if (item == m_base.constEnd()) {
+        return false;
+    }
+
+    // check the times first, which is cheaper than a digest that is not cached yet
+    const TimeInfo& timeInfo = sourceEntry->timeInfo();
+    return item->lastModificationTime == serializedTime(timeInfo.lastModificationTime())
+           && item->locationChanged == serializedTime(timeInfo.locationChanged())
+           && item->digest == sourceEntry->contentDigest().left(BASE_MANIFEST_DIGEST_SIZE);
+}
+
 bool Merger::markOlderEntry(Entry* entry)
 {
     entry->attributes()->set(
@@ -232,15 +544,10 @@ void Merger::eraseEntry(Entry* entry)
     Database* database = entry->database();
     // most simple method to remove an item from DeletedObjects :(
     const QList<DeletedObject> deletions = database->deletedObjects();
-    Group* parentGroup = entry->group();
-    const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
-    if (parentGroup) {
-        parentGroup->setUpdateTimeinfo(false);
-    }
-    delete entry;
-    if (parentGroup) {
-        parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
+    if (m_targetEntries.value(entry->uuid()) == entry) {
+        m_targetEntries.remove(entry->uuid());
     }
+    deleteEntry(entry);
     database->setDeletedObjects(deletions);
 }
 
@@ -249,15 +556,10 @@ void Merger::eraseGroup(Group* group)
     Database* database = group->database();
     // most simple method to remove an item from DeletedObjects :(
     const QList<DeletedObject> deletions = database->deletedObjects();
-    Group* parentGroup = group->parentGroup();
-    const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
-    if (parentGroup) {
-        parentGroup->setUpdateTimeinfo(false);
-    }
-    delete group;
-    if (parentGroup) {
-        parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
+    if (m_targetGroups.value(group->uuid()) == group) {
+        m_targetGroups.remove(group->uuid());
     }
+    deleteGroup(group);
     database->setDeletedObjects(deletions);
 }
 
@@ -269,11 +571,13 @@ Merger::ChangeList Merger::resolveEntryConflict_Duplicate(const MergeContext& co
     if (comparison < 0) {
         Entry* clonedEntry = sourceEntry->clone(Entry::CloneNewUuid | Entry::CloneIncludeHistory);
         moveEntry(clonedEntry, context.m_targetGroup);
+        m_targetEntries.insert(clonedEntry->uuid(), clonedEntry);
         markOlderEntry(targetEntry);
         changes << tr("Adding backup for older target %1 [%2]").arg(targetEntry->title(), targetEntry->uuidToHex());
     } else if (comparison > 0) {
         Entry* clonedEntry = sourceEntry->clone(Entry::CloneNewUuid | Entry::CloneIncludeHistory);
         moveEntry(clonedEntry, context.m_targetGroup);
+        m_targetEntries.insert(clonedEntry->uuid(), clonedEntry);
         markOlderEntry(clonedEntry);
         changes << tr("Adding backup for older source %1 [%2]").arg(sourceEntry->title(), sourceEntry->uuidToHex());
     }
@@ -340,6 +644,7 @@ Merger::ChangeList Merger::resolveEntryConflict_MergeHistories(const MergeContex
         moveEntry(clonedEntry, currentGroup);
         mergeHistory(targetEntry, clonedEntry, mergeMethod);
         eraseEntry(targetEntry);
+        m_targetEntries.insert(clonedEntry->uuid(), clonedEntry);
     } else {
         qDebug("Merge %s/%s with local on top/under %s",
                qPrintable(targetEntry->title()),
@@ -361,6 +666,13 @@ Merger::ChangeList Merger::resolveEntryConflict(const MergeContext& context, con
     // so when we import data from a remote source, it may represent the (or even some msec newer) data
     // which may be discarded due to higher runtime precision
 
+    // Identical entries with identical histories need no conflict resolution in any mode. Entry::equals
+    // compares the cached content digests of the entries and their history items, so unchanged entries
+    // are skipped without comparing every attribute and attachment.
+    if (targetEntry->equals(sourceEntry, CompareItemIgnoreMilliseconds)) {
+        return changes;
+    }
+
     Group::MergeMode mergeMode = m_mode == Group::Default ? context.m_targetGroup->mergeMode() : m_mode;
     switch (mergeMode) {
     case Group::Duplicate:
@@ -513,12 +825,12 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         if (!mergedDeletions.contains(object.uuid)) {
             mergedDeletions[object.uuid] = object;
 
-            auto* entry = context.m_targetRootGroup->findEntryByUuid(object.uuid);
+            auto* entry = m_targetEntries.value(object.uuid);
             if (entry) {
                 entries << entry;
                 continue;
             }
-            auto* group = context.m_targetRootGroup->findGroupByUuid(object.uuid);
+            auto* group = m_targetGroups.value(object.uuid);
             if (group) {
                 groups << group;
                 continue;
@@ -544,23 +856,24 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         } else {
             changes << tr("Deleting orphan %1 [%2]").arg(entry->title(), entry->uuidToHex());
         }
-        // Entry is inserted into deletedObjects after deletions are processed
-        eraseEntry(entry);
+        // Entry is inserted into deletedObjects after deletions are processed,
+        // which replaces the deleted objects added while deleting
+        m_targetEntries.remove(entry->uuid());
+        deleteEntry(entry);
     }
 
+    // we need to finish all children before we are able to determine if the group can be removed
+    std::stable_sort(groups.begin(), groups.end(), [](const Group* lhs, const Group* rhs) {
+        return groupDepth(lhs) > groupDepth(rhs);
+    });
     while (!groups.isEmpty()) {
         auto* group = groups.takeFirst();
-        if (!(group->children().toSet() & groups.toSet()).isEmpty()) {
-            // we need to finish all children before we are able to determine if the group can be removed
-            groups << group;
-            continue;
-        }
         const auto& object = mergedDeletions[group->uuid()];
         if (group->timeInfo().lastModificationTime() > object.deletionTime) {
             // keep deleted group since it was changed after deletion date
             continue;
         }
-        if (!group->entriesRecursive(false).isEmpty() || !group->groupsRecursive(false).isEmpty()) {
+        if (!group->entries().isEmpty() || !group->children().isEmpty()) {
             // keep deleted group since it contains undeleted content
             continue;
         }
@@ -570,10 +883,11 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         } else {
             changes << tr("Deleting orphan %1 [%2]").arg(group->name(), group->uuidToHex());
         }
-        eraseGroup(group);
+        m_targetGroups.remove(group->uuid());
+        deleteGroup(group);
     }
     // Put every deletion to the earliest date of deletion
-    if (deletions != context.m_targetDb->deletedObjects()) {
+    if (deletions != targetDeletions) {
         changes << tr("Changed deleted objects");
     }
     context.m_targetDb->setDeletedObjects(deletions);
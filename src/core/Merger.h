@@ -19,8 +19,11 @@
 #define KEEPASSXC_MERGER_H
 
 #include "core/Group.h"
+#include <QHash>
 #include <QObject>
 #include <QPointer>
+#include <QSet>
+#include <QUuid>
 
 class Database;
 class Entry;
@@ -33,12 +36,27 @@ public:
     Merger(const Group* sourceGroup, Group* targetGroup);
     void setForcedMergeMode(Group::MergeMode mode);
     void resetForcedMergeMode();
+    bool setBaseManifest(const QByteArray& manifest);
+    void setConcurrentPlanning(bool enabled);
     bool merge();
 
+    static QByteArray createBaseManifest(const Database* db);
+    static QByteArray storedBaseManifest(const Database* db);
+    static bool storeBaseManifest(Database* db);
+
+    static const QString BaseManifestKey;
+
 private:
     typedef QString Change;
     typedef QStringList ChangeList;
 
+    struct BaseItem
+    {
+        QByteArray digest;
+        qint64 lastModificationTime;
+        qint64 locationChanged;
+    };
+
     struct MergeContext
     {
         QPointer<const Database> m_sourceDb;
@@ -48,9 +66,19 @@ private:
         QPointer<const Group> m_sourceGroup;
         QPointer<Group> m_targetGroup;
     };
+    struct GroupPlan
+    {
+        const Group* sourceGroup;
+        QList<const Entry*> unchangedEntries;
+    };
+
+    void indexTargetItems();
+    void planConcurrently();
+    void planGroup(GroupPlan& plan) const;
     ChangeList mergeGroup(const MergeContext& context);
     ChangeList mergeDeletions(const MergeContext& context);
     ChangeList mergeMetadata(const MergeContext& context);
+    bool isUnchangedSinceBase(const Entry* sourceEntry) const;
     bool markOlderEntry(Entry* entry);
     bool mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::MergeMode mergeMethod);
     void moveEntry(Entry* entry, Group* targetGroup);
@@ -67,6 +95,14 @@ private:
 private:
     MergeContext m_context;
     Group::MergeMode m_mode;
+    // lookup tables for the target database, kept up to date while merging
+    QHash<QUuid, Entry*> m_targetEntries;
+    QHash<QUuid, Group*> m_targetGroups;
+    // entry versions the target has already incorporated, for three-way merges
+    QHash<QUuid, BaseItem> m_base;
+    bool m_concurrentPlanning;
+    // source entries found to need no merge while planning
+    QSet<const Entry*> m_unchangedEntries;
 };
 
 #endif // KEEPASSXC_MERGER_H
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordHealth.h"
+
+#include <QObject>
+#include <QSet>
+#include <QVector>
+#include <QtConcurrent>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "crypto/CryptoHash.h"
+#include "crypto/Random.h"
+#include <zxcvbn.h>
+
+namespace
+{
+    struct Estimate
+    {
+        QByteArray digest;
+        QString password;
+        double entropy;
+    };
+
+    bool isRecycled(const Entry* entry, const Group* recycleBin)
+    {
+        if (!recycleBin) {
+            return false;
+        }
+
+        for (const Group* group = entry->group(); group; group = group->parentGroup()) {
+            if (group == recycleBin) {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+PasswordHealth::PasswordHealth()
+    : m_digestKey(randomGen()->randomArray(32))
+{
+}
+
+/**
+ * Whether the entry should be brought to the user's attention
+ */
+bool PasswordHealth::Item::hasProblems() const
+{
+    return quality <= Quality::Weak || reuseCount > 1 || expired;
+}
+
+/**
+ * Analyze the passwords of the entries of the database, in the order of the
+ * group tree. Entries in the recycle bin and history items are skipped.
+ *
+ * Must be called on the thread owning the database, only the strength
+ * estimation itself runs on the global thread pool.
+ */
+QList<PasswordHealth::Item> PasswordHealth::analyze(const Database* db)
+{
+    QList<Item> items;
+    // digest of the password of every item, and the one counted as used by
+    // the item, which is empty for references to the password of another entry
+    QList<QByteArray> digests;
+    QList<QByteArray> useDigests;
+    QHash<QByteArray, int> useCounts;
+    QVector<Estimate> estimates;
+    QSet<QByteArray> pending;
+
+    const Group* recycleBin = db->metadata()->recycleBin();
+    const QList<Entry*> entries = db->rootGroup()->entriesRecursive();
+    for (Entry* entry : entries) {
+        if (isRecycled(entry, recycleBin)) {
+            continue;
+        }
+
+        Item item;
+        item.entry = entry;
+        item.entropy = 0.0;
+        item.quality = Quality::Bad;
+        item.reuseCount = 1;
+        item.expired = entry->isExpired();
+        items.append(item);
+
+        const QString password = entry->resolveMultiplePlaceholders(entry->password());
+        if (password.isEmpty()) {
+            digests.append(QByteArray());
+            useDigests.append(QByteArray());
+            continue;
+        }
+
+        const QByteArray key = digest(password);
+        digests.append(key);
+        if (entry->attributes()->isReference(EntryAttributes::PasswordKey)) {
+            useDigests.append(QByteArray());
+        } else {
+            useDigests.append(key);
+            ++useCounts[key];
+        }
+
+        if (!m_entropies.contains(key) && !pending.contains(key)) {
+            pending.insert(key);
+            Estimate estimate = {key, password, 0.0};
+            estimates.append(estimate);
+        }
+    }
+
+    // zxcvbn only reads its dictionary, the passwords are estimated independently
+    QtConcurrent::blockingMap(estimates, [](Estimate& estimate) {
+        estimate.entropy = ZxcvbnMatch(estimate.password.toLatin1(), nullptr, nullptr);
+    });
+
+    for (const Estimate& estimate : asConst(estimates)) {
+        m_entropies.insert(estimate.digest, estimate.entropy);
+    }
+
+    // keep only the estimates of the passwords still in use
+    QHash<QByteArray, double> usedEntropies;
+    for (int i = 0; i < items.size(); ++i) {
+        const QByteArray& key = digests.at(i);
+        if (key.isEmpty()) {
+            continue;
+        }
+
+        Item& item = items[i];
+        item.entropy = m_entropies.value(key);
+        item.quality = quality(item.entropy);
+        if (!useDigests.at(i).isEmpty()) {
+            item.reuseCount = useCounts.value(key);
+        }
+        usedEntropies.insert(key, item.entropy);
+    }
+    m_entropies.swap(usedEntropies);
+
+    return items;
+}
+
+/**
+ * Forget the estimates of previous analyses
+ */
+void PasswordHealth::clearCache()
+{
+    m_entropies.clear();
+}
+
+/**
+ * Number of distinct passwords whose estimate is kept for the next analysis
+ */
+int PasswordHealth::cacheSize() const
+{
+    return m_entropies.size();
+}
+
+/**
+ * Quality of a password with the given entropy, using the ranges of the
+ * strength indicator of the password generator
+ */
+PasswordHealth::Quality PasswordHealth::quality(double entropy)
+{
+    if (entropy <= 0.0) {
+        return Quality::Bad;
+    } else if (entropy < 40) {
+        return Quality::Poor;
+    } else if (entropy < 65) {
+        return Quality::Weak;
+    } else if (entropy < 100) {
+        return Quality::Good;
+    }
+    return Quality::Excellent;
+}
+
+QString PasswordHealth::qualityName(Quality quality)
+{
+    switch (quality) {
+    case Quality::Bad:
+        return QObject::tr("Bad", "Password quality");
+    case Quality::Poor:
+        return QObject::tr("Poor", "Password quality");
+    case Quality::Weak:
+        return QObject::tr("Weak", "Password quality");
+    case Quality::Good:
+        return QObject::tr("Good", "Password quality");
+    case Quality::Excellent:
+        return QObject::tr("Excellent", "Password quality");
+    }
+    return QString();
+}
+
+QByteArray PasswordHealth::digest(const QString& password) const
+{
+    return CryptoHash::hmac(password.toUtf8(), m_digestKey, CryptoHash::Sha256);
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PASSWORDHEALTH_H
+#define KEEPASSXC_PASSWORDHEALTH_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class Database;
+class Entry;
+
+/**
+ * Password health report of a database: the estimated strength of the
+ * password of every entry outside the recycle bin, passwords shared by
+ * several entries and expired entries.
+ *
+ * The strength of the distinct passwords is estimated concurrently. The
+ * estimates are kept by password digest, so analyzing the database again
+ * only estimates passwords that were added or changed since.
+ */
+class PasswordHealth
+{
+public:
+    enum class Quality
+    {
+        Bad,
+        Poor,
+        Weak,
+        Good,
+        Excellent
+    };
+
+    struct Item
+    {
+        Entry* entry;
+        double entropy;
+        Quality quality;
+        // number of entries using the same password, including this one
+        int reuseCount;
+        bool expired;
+
+        bool hasProblems() const;
+    };
+
+    PasswordHealth();
+
+    QList<Item> analyze(const Database* db);
+    void clearCache();
+    int cacheSize() const;
+
+    static Quality quality(double entropy);
+    static QString qualityName(Quality quality);
+
+private:
+    QByteArray digest(const QString& password) const;
+
+    // random key of the password digests, they are never stored
+    const QByteArray m_digestKey;
+    QHash<QByteArray, double> m_entropies;
+};
+
+#endif // KEEPASSXC_PASSWORDHEALTH_H
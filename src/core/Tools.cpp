@@ -26,6 +26,7 @@
 #include <QImageReader>
 #include <QLocale>
 #include <QStringList>
+#include <QUrl>
 #include <QElapsedTimer>
 
 #include <cctype>
@@ -154,6 +155,25 @@ bool isBase64(const QByteArray& ba)
     return regexp.exactMatch(base64);
 }
 
+/**
+ * Gets the registrable domain of the host of an URL, the part below the
+ * public suffix, e.g. https://another.example.co.uk -> example.co.uk
+ */
+QString registrableDomain(const QUrl& url)
+{
+    QString hostname = url.host();
+    const QString topLevelDomain = url.topLevelDomain();
+
+    if (hostname.isEmpty() || !hostname.contains(topLevelDomain)) {
+        return {};
+    }
+
+    // Remove the top level domain part from the hostname, e.g. another.example.co.uk -> another.example
+    hostname.chop(topLevelDomain.length());
+    // Split the hostname, select the last part and append the top level domain back to it
+    return hostname.split('.').last() + topLevelDomain;
+}
+
 void sleep(int ms)
 {
     Q_ASSERT(ms >= 0);
@@ -27,6 +27,7 @@
 #include <algorithm>
 
 class QIODevice;
+class QUrl;
 
 namespace Tools
 {
@@ -36,6 +37,7 @@ bool readAllFromDevice(QIODevice* device, QByteArray& data);
 QString imageReaderFilter();
 bool isHex(const QByteArray& ba);
 bool isBase64(const QByteArray& ba);
+QString registrableDomain(const QUrl& url);
 void sleep(int ms);
 void wait(int ms);
 
@@ -47,7 +47,7 @@ bool AesKdf::processParameters(const QVariantMap& p)
     return setSeed(seed);
 }
 
-QVariantMap AesKdf::writeParameters()
+QVariantMap AesKdf::writeParameters() const
 {
     QVariantMap p;
 
@@ -105,23 +105,3 @@ QSharedPointer<Kdf> AesKdf::clone() const
 {
     return QSharedPointer<AesKdf>::create(*this);
 }
-
-int AesKdf::benchmarkImpl(int msec) const
-{
-    QByteArray key = QByteArray(16, '\x7E');
-    QByteArray seed = QByteArray(32, '\x4B');
-    QByteArray iv(16, 0);
-
-    SymmetricCipher cipher(SymmetricCipher::Aes256, SymmetricCipher::Ecb, SymmetricCipher::Encrypt);
-    cipher.init(seed, iv);
-
-    quint64 rounds = 1000000;
-    QElapsedTimer timer;
-    timer.start();
-
-    if (!cipher.processInPlace(key, rounds)) {
-        return -1;
-    }
-
-    return static_cast<int>(rounds * (static_cast<float>(msec) / timer.elapsed()));
-}
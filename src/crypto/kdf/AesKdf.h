@@ -27,13 +27,10 @@ public:
     explicit AesKdf(bool legacyKdbx3);
 
     bool processParameters(const QVariantMap& p) override;
-    QVariantMap writeParameters() override;
+    QVariantMap writeParameters() const override;
     bool transform(const QByteArray& raw, QByteArray& result) const override;
     QSharedPointer<Kdf> clone() const override;
 
-protected:
-    int benchmarkImpl(int msec) const override;
-
 private:
     Q_REQUIRED_RESULT static bool
     transformKeyRaw(const QByteArray& key, const QByteArray& seed, int rounds, QByteArray* result);
@@ -130,7 +130,7 @@ bool Argon2Kdf::processParameters(const QVariantMap& p)
     return true;
 }
 
-QVariantMap Argon2Kdf::writeParameters()
+QVariantMap Argon2Kdf::writeParameters() const
 {
     QVariantMap p;
     p.insert(KeePass2::KDFPARAM_UUID, KeePass2::KDF_ARGON2.toRfc4122());
@@ -196,18 +196,8 @@ QSharedPointer<Kdf> Argon2Kdf::clone() const
     return QSharedPointer<Argon2Kdf>::create(*this);
 }
 
-int Argon2Kdf::benchmarkImpl(int msec) const
+QString Argon2Kdf::calibrationKey() const
 {
-    QByteArray key = QByteArray(16, '\x7E');
-    QByteArray seed = QByteArray(32, '\x4B');
-
-    QElapsedTimer timer;
-    timer.start();
-
-    int rounds = 4;
-    if (transformKeyRaw(key, seed, version(), rounds, memory(), parallelism(), key)) {
-        return static_cast<int>(rounds * (static_cast<float>(msec) / timer.elapsed()));
-    }
-
-    return 1;
+    // the transformation cost depends on all parameters except the salt
+    return QString("%1/%2/%3/%4").arg(Kdf::calibrationKey()).arg(m_version).arg(m_memory).arg(m_parallelism);
 }
@@ -26,7 +26,7 @@ public:
     Argon2Kdf();
 
     bool processParameters(const QVariantMap& p) override;
-    QVariantMap writeParameters() override;
+    QVariantMap writeParameters() const override;
     bool transform(const QByteArray& raw, QByteArray& result) const override;
     QSharedPointer<Kdf> clone() const override;
 
@@ -38,7 +38,7 @@ public:
     bool setParallelism(quint32 threads);
 
 protected:
-    int benchmarkImpl(int msec) const override;
+    QString calibrationKey() const override;
 
     quint32 m_version;
     quint64 m_memory;
@@ -16,12 +16,75 @@
  */
 
 #include "Kdf.h"
-#include "Kdf_p.h"
 
-#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QSysInfo>
+#include <QThread>
 
+#include <climits>
+
+#include "core/Clock.h"
 #include "crypto/Random.h"
 
+namespace
+{
+    // Minimum duration of a single calibration sample. Shorter samples are
+    // dominated by timer resolution and scheduling noise.
+    const qint64 CALIBRATION_MIN_SAMPLE_NSEC = 100 * 1000 * 1000;
+
+    // Calibrations older than this are measured again, e.g. after the
+    // machine was upgraded in a way the CPU identification does not reveal.
+    const uint CALIBRATION_MAX_AGE_SECS = 30 * 24 * 60 * 60;
+
+    struct Calibration
+    {
+        qreal nsecPerRound;
+        qreal overheadNsec;
+        uint measuredAt;
+    };
+
+    QMutex calibrationMutex;
+    QHash<QString, Calibration> calibrations;
+
+    /**
+     * @return description of the CPU, as specific as the platform allows
+     */
+    QString cpuIdentity()
+    {
+        QString model;
+#ifdef Q_OS_LINUX
+        QFile cpuInfo("/proc/cpuinfo");
+        if (cpuInfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            while (!cpuInfo.atEnd()) {
+                const QByteArray line = cpuInfo.readLine();
+                if (line.startsWith("model name")) {
+                    model = QString::fromUtf8(line.mid(line.indexOf(':') + 1)).trimmed();
+                    break;
+                }
+            }
+        }
+#endif
+        return QString("%1/%2/%3").arg(QSysInfo::currentCpuArchitecture(), model).arg(QThread::idealThreadCount());
+    }
+
+    QString machineCalibrationKey(const QString& kdfKey)
+    {
+        // results are only valid for the CPU they were measured on
+        static const QString cpu = cpuIdentity();
+        return QString("%1/%2").arg(cpu, kdfKey);
+    }
+
+    bool isExpired(const Calibration& calibration)
+    {
+        const uint now = Clock::currentSecondsSinceEpoch();
+        return calibration.measuredAt > now || now - calibration.measuredAt > CALIBRATION_MAX_AGE_SECS;
+    }
+} // namespace
+
 Kdf::Kdf(const QUuid& uuid)
     : m_rounds(KDF_DEFAULT_ROUNDS)
     , m_seed(QByteArray(KDF_DEFAULT_SEED_SIZE, 0))
@@ -69,32 +132,140 @@ void Kdf::randomizeSeed()
     setSeed(randomGen()->randomArray(m_seed.size()));
 }
 
-int Kdf::benchmark(int msec) const
+/**
+ * Determine the number of rounds needed for a key transformation
+ * with the current KDF parameters to take the given amount of time.
+ *
+ * The real transform() is timed at the configured parameters (e.g. Argon2
+ * memory and parallelism) for two different round counts, which yields the
+ * cost per round as well as the fixed per-transformation overhead. The
+ * calibration is cached per CPU and parameter set for a limited time, so
+ * subsequent calls for the same configuration return immediately.
+ *
+ * @param msec desired transformation time in milliseconds
+ * @param recalibrate measure again even if a cached calibration exists
+ * @return number of rounds
+ */
+int Kdf::benchmark(int msec, bool recalibrate) const
+{
+    const QString key = machineCalibrationKey(calibrationKey());
+
+    Calibration calibration;
+    bool cached = false;
+    if (!recalibrate) {
+        QMutexLocker locker(&calibrationMutex);
+        auto it = calibrations.constFind(key);
+        if (it != calibrations.constEnd() && !isExpired(it.value())) {
+            calibration = it.value();
+            cached = true;
+        }
+    }
+
+    if (!cached) {
+        if (!calibrate(calibration.nsecPerRound, calibration.overheadNsec)) {
+            return 1;
+        }
+        calibration.measuredAt = Clock::currentSecondsSinceEpoch();
+        QMutexLocker locker(&calibrationMutex);
+        calibrations.insert(key, calibration);
+    }
+
+    qreal rounds = (msec * 1000000.0 - calibration.overheadNsec) / calibration.nsecPerRound;
+    return static_cast<int>(qBound<qreal>(1.0, rounds, INT_MAX - 1));
+}
+
+/**
+ * Export all cached calibration results, e.g. for storing them in the
+ * application configuration.
+ */
+QVariantMap Kdf::calibrationCache()
 {
-    BenchmarkThread thread1(msec, this);
-    BenchmarkThread thread2(msec, this);
+    QMutexLocker locker(&calibrationMutex);
 
-    thread1.start();
-    thread2.start();
+    QVariantMap cache;
+    for (auto it = calibrations.constBegin(); it != calibrations.constEnd(); ++it) {
+        const Calibration& calibration = it.value();
+        if (!isExpired(calibration)) {
+            cache.insert(it.key(),
+                         QVariantList() << calibration.nsecPerRound << calibration.overheadNsec
+                                        << calibration.measuredAt);
+        }
+    }
+    return cache;
+}
 
-    thread1.wait();
-    thread2.wait();
+/**
+ * Import calibration results previously obtained with calibrationCache().
+ * Malformed and expired entries are ignored.
+ */
+void Kdf::restoreCalibrationCache(const QVariantMap& cache)
+{
+    QMutexLocker locker(&calibrationMutex);
 
-    return qMax(1, (thread1.rounds() + thread2.rounds()) / 2);
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it) {
+        const QVariantList values = it.value().toList();
+        if (values.size() != 3) {
+            continue;
+        }
+        Calibration calibration;
+        calibration.nsecPerRound = values[0].toDouble();
+        calibration.overheadNsec = values[1].toDouble();
+        calibration.measuredAt = values[2].toUInt();
+        if (calibration.nsecPerRound > 0 && calibration.overheadNsec >= 0 && !isExpired(calibration)) {
+            calibrations.insert(it.key(), calibration);
+        }
+    }
 }
 
-Kdf::BenchmarkThread::BenchmarkThread(int msec, const Kdf* kdf)
-    : m_msec(msec)
-    , m_kdf(kdf)
+/**
+ * @return key identifying all parameters that influence the transformation cost
+ */
+QString Kdf::calibrationKey() const
 {
+    return m_uuid.toString();
 }
 
-int Kdf::BenchmarkThread::rounds()
+bool Kdf::calibrate(qreal& nsecPerRound, qreal& overheadNsec) const
 {
-    return m_rounds;
+    int rounds = 1;
+    qint64 first = measureTransform(rounds);
+    while (first >= 0 && first < CALIBRATION_MIN_SAMPLE_NSEC && rounds <= INT_MAX / 4) {
+        rounds *= 2;
+        first = measureTransform(rounds);
+    }
+
+    qint64 second = measureTransform(rounds * 2);
+    if (first < 0 || second < 0) {
+        return false;
+    }
+
+    if (second > first) {
+        nsecPerRound = static_cast<qreal>(second - first) / rounds;
+        overheadNsec = qMax<qreal>(0.0, first - nsecPerRound * rounds);
+    } else {
+        // measurement noise exceeded the cost of the additional rounds
+        nsecPerRound = static_cast<qreal>(second) / (rounds * 2);
+        overheadNsec = 0.0;
+    }
+    nsecPerRound = qMax<qreal>(1.0, nsecPerRound);
+    return true;
 }
 
-void Kdf::BenchmarkThread::run()
+/**
+ * @return time in nanoseconds a transformation with the given number of rounds took, -1 on error
+ */
+qint64 Kdf::measureTransform(int rounds) const
 {
-    m_rounds = m_kdf->benchmarkImpl(m_msec);
+    QSharedPointer<Kdf> probe = clone();
+    probe->setRounds(rounds);
+
+    QByteArray key(32, '\x7E');
+    QByteArray result;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!probe->transform(key, result)) {
+        return -1;
+    }
+    return timer.nsecsElapsed();
 }
@@ -39,20 +39,25 @@ public:
     virtual void randomizeSeed();
 
     virtual bool processParameters(const QVariantMap& p) = 0;
-    virtual QVariantMap writeParameters() = 0;
+    virtual QVariantMap writeParameters() const = 0;
     virtual bool transform(const QByteArray& raw, QByteArray& result) const = 0;
     virtual QSharedPointer<Kdf> clone() const = 0;
 
-    int benchmark(int msec) const;
+    int benchmark(int msec, bool recalibrate = false) const;
+
+    static QVariantMap calibrationCache();
+    static void restoreCalibrationCache(const QVariantMap& cache);
 
 protected:
-    virtual int benchmarkImpl(int msec) const = 0;
+    virtual QString calibrationKey() const;
 
     int m_rounds;
     QByteArray m_seed;
 
 private:
-    class BenchmarkThread;
+    bool calibrate(qreal& nsecPerRound, qreal& overheadNsec) const;
+    qint64 measureTransform(int rounds) const;
+
     const QUuid m_uuid;
 };
 #endif // KEEPASSX_KDF_H
@@ -66,6 +66,57 @@ Database* KdbxReader::readDatabase(QIODevice* device, QSharedPointer<const Compo
 {
     device->seek(0);
 
+    StoreDataStream headerStream(device);
+    headerStream.open(QIODevice::ReadOnly);
+    bool ok = readHeader(headerStream);
+    headerStream.close();
+
+    if (!ok) {
+        return nullptr;
+    }
+
+    // read payload
+    auto* db = readDatabaseImpl(device, headerStream.storedData(), std::move(key), keepDatabase);
+
+    if (saveXml()) {
+        m_xmlData.clear();
+        decryptXmlInnerStream(m_xmlData, db);
+    }
+
+    return db;
+}
+
+/**
+ * Read only the KDBX header from device and return the key derivation
+ * function it specifies. The payload is not decrypted, so no key is needed.
+ * The device will automatically be reset to 0 before reading.
+ *
+ * @param device input device
+ * @return KDF with the parameters stored in the header, nullptr on failure
+ */
+QSharedPointer<Kdf> KdbxReader::readKdf(QIODevice* device)
+{
+    device->seek(0);
+
+    StoreDataStream headerStream(device);
+    headerStream.open(QIODevice::ReadOnly);
+    bool ok = readHeader(headerStream);
+    headerStream.close();
+
+    if (!ok) {
+        return {};
+    }
+    return m_db->kdf();
+}
+
+/**
+ * Read KDBX magic numbers and all header fields.
+ *
+ * @param headerStream input header stream positioned at the file start
+ * @return true on success
+ */
+bool KdbxReader::readHeader(StoreDataStream& headerStream)
+{
     m_db.reset(new Database());
     m_xmlData.clear();
     m_masterSeed.clear();
@@ -73,13 +124,10 @@ Database* KdbxReader::readDatabase(QIODevice* device, QSharedPointer<const Compo
     m_streamStartBytes.clear();
     m_protectedStreamKey.clear();
 
-    StoreDataStream headerStream(device);
-    headerStream.open(QIODevice::ReadOnly);
-
     // read KDBX magic numbers
     quint32 sig1, sig2;
     if (!readMagicNumbers(&headerStream, sig1, sig2, m_kdbxVersion)) {
-        return nullptr;
+        return false;
     }
     m_kdbxSignature = qMakePair(sig1, sig2);
 
@@ -90,21 +138,7 @@ Database* KdbxReader::readDatabase(QIODevice* device, QSharedPointer<const Compo
     while (readHeaderField(headerStream) && !hasError()) {
     }
 
-    headerStream.close();
-
-    if (hasError()) {
-        return nullptr;
-    }
-
-    // read payload
-    auto* db = readDatabaseImpl(device, headerStream.storedData(), std::move(key), keepDatabase);
-
-    if (saveXml()) {
-        m_xmlData.clear();
-        decryptXmlInnerStream(m_xmlData, db);
-    }
-
-    return db;
+    return !hasError();
 }
 
 bool KdbxReader::hasError() const
@@ -41,6 +41,7 @@ public:
 
     static bool readMagicNumbers(QIODevice* device, quint32& sig1, quint32& sig2, quint32& version);
     Database* readDatabase(QIODevice* device, QSharedPointer<const CompositeKey> key, bool keepDatabase = false);
+    QSharedPointer<Kdf> readKdf(QIODevice* device);
 
     bool hasError() const;
     QString errorString() const;
@@ -102,6 +103,8 @@ protected:
     QByteArray m_xmlData;
 
 private:
+    bool readHeader(StoreDataStream& headerStream);
+
     bool m_saveXml = false;
     bool m_error = false;
     QString m_errorStr = "";
@@ -57,9 +57,43 @@ Database* KeePass2Reader::readDatabase(const QString& filename, QSharedPointer<c
  * @return pointer to the read database, nullptr on failure
  */
 Database* KeePass2Reader::readDatabase(QIODevice* device, QSharedPointer<const CompositeKey> key, bool keepDatabase)
+{
+    if (!selectReader(device)) {
+        return nullptr;
+    }
+
+    m_reader->setSaveXml(m_saveXml);
+    return m_reader->readDatabase(device, std::move(key), keepDatabase);
+}
+
+/**
+ * Read the key derivation function from the database header without decrypting
+ * the database, e.g. to derive the master key ahead of time.
+ *
+ * @param device input device
+ * @return KDF stored in the header, nullptr on failure
+ */
+QSharedPointer<Kdf> KeePass2Reader::readKdf(QIODevice* device)
+{
+    if (!selectReader(device)) {
+        return {};
+    }
+
+    return m_reader->readKdf(device);
+}
+
+/**
+ * Detect the file format from the magic numbers on the device
+ * and instantiate the matching KDBX reader.
+ *
+ * @param device input device
+ * @return true if the file format is supported
+ */
+bool KeePass2Reader::selectReader(QIODevice* device)
 {
     m_error = false;
     m_errorStr.clear();
+    m_reader.reset();
 
     quint32 signature1, signature2;
     bool ok = KdbxReader::readMagicNumbers(device, signature1, signature2, m_version);
@@ -69,7 +103,7 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, QSharedPointer<const C
 
     if (!ok || signature1 != KeePass2::SIGNATURE_1 || signature2 != KeePass2::SIGNATURE_2) {
         raiseError(tr("Not a KeePass database."));
-        return nullptr;
+        return false;
     }
 
     if (signature2 == KeePass1::SIGNATURE_2) {
@@ -77,13 +111,13 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, QSharedPointer<const C
                       "You can import it by clicking on Database > 'Import KeePass 1 database...'.\n"
                       "This is a one-way migration. You won't be able to open the imported "
                       "database with the old KeePassX 0.4 version."));
-        return nullptr;
+        return false;
     }
 
     quint32 maxVersion = KeePass2::FILE_VERSION_4 & KeePass2::FILE_VERSION_CRITICAL_MASK;
     if (m_version < KeePass2::FILE_VERSION_MIN || m_version > maxVersion) {
         raiseError(tr("Unsupported KeePass 2 database version."));
-        return nullptr;
+        return false;
     }
 
     // determine file format (KDBX 2/3 or 4)
@@ -93,8 +127,7 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, QSharedPointer<const C
         m_reader.reset(new Kdbx4Reader());
     }
 
-    m_reader->setSaveXml(m_saveXml);
-    return m_reader->readDatabase(device, std::move(key), keepDatabase);
+    return true;
 }
 
 bool KeePass2Reader::hasError() const
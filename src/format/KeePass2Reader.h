@@ -37,6 +37,7 @@ class KeePass2Reader
 public:
     Database* readDatabase(const QString& filename, QSharedPointer<const CompositeKey> key);
     Database* readDatabase(QIODevice* device, QSharedPointer<const CompositeKey> key, bool keepDatabase = false);
+    QSharedPointer<Kdf> readKdf(QIODevice* device);
 
     bool hasError() const;
     QString errorString() const;
@@ -48,6 +49,7 @@ public:
     quint32 version() const;
 
 private:
+    bool selectReader(QIODevice* device);
     void raiseError(const QString& errorMessage);
 
     bool m_saveXml = false;
@@ -21,6 +21,7 @@
 
 #include "core/Config.h"
 #include "core/Database.h"
+#include "core/DatabaseOpenScheduler.h"
 #include "core/FilePath.h"
 #include "crypto/Random.h"
 #include "format/KeePass2Reader.h"
@@ -34,13 +35,27 @@
 
 #include "config-keepassx.h"
 
+#include <QFileInfo>
+#include <QLineEdit>
 #include <QSharedPointer>
 #include <QtConcurrentRun>
 
+namespace
+{
+    // Every transformation may take seconds and, with Argon2, up to gigabytes
+    // of memory, so only few are started ahead of time per opened file
+    const int MAX_SPECULATIVE_KEY_DERIVATIONS = 3;
+} // namespace
+
 DatabaseOpenWidget::DatabaseOpenWidget(QWidget* parent)
     : DialogyWidget(parent)
     , m_ui(new Ui::DatabaseOpenWidget())
     , m_db(nullptr)
+    , m_openPending(false)
+    , m_keyDerivationRunning(false)
+    , m_keyDerivationCurrent(false)
+    , m_keyDerivationRequested(false)
+    , m_keyDerivationCount(0)
 {
     m_ui->setupUi(this);
 
@@ -62,6 +77,18 @@ DatabaseOpenWidget::DatabaseOpenWidget(QWidget* parent)
     connect(m_ui->buttonBox, SIGNAL(accepted()), SLOT(openDatabase()));
     connect(m_ui->buttonBox, SIGNAL(rejected()), SLOT(reject()));
 
+    // start deriving the key in the background once an input is left, any
+    // change of the inputs discards what has been derived so far
+    connect(&m_keyDerivationWatcher, SIGNAL(finished()), SLOT(keyDerivationFinished()));
+    connect(m_ui->editPassword, SIGNAL(editingFinished()), SLOT(deriveKey()));
+    connect(m_ui->comboKeyFile->lineEdit(), SIGNAL(editingFinished()), SLOT(deriveKey()));
+    connect(m_ui->editPassword, SIGNAL(textChanged(QString)), SLOT(resetKeyDerivation()));
+    connect(m_ui->comboKeyFile, SIGNAL(editTextChanged(QString)), SLOT(resetKeyDerivation()));
+    connect(m_ui->checkPassword, SIGNAL(toggled(bool)), SLOT(resetKeyDerivation()));
+    connect(m_ui->checkKeyFile, SIGNAL(toggled(bool)), SLOT(resetKeyDerivation()));
+    connect(m_ui->checkChallengeResponse, SIGNAL(toggled(bool)), SLOT(resetKeyDerivation()));
+    connect(m_ui->comboChallengeResponse, SIGNAL(currentIndexChanged(int)), SLOT(resetKeyDerivation()));
+
 #ifdef WITH_XC_YUBIKEY
     m_ui->yubikeyProgress->setVisible(false);
     QSizePolicy sp = m_ui->yubikeyProgress->sizePolicy();
@@ -120,6 +147,9 @@ void DatabaseOpenWidget::hideEvent(QHideEvent* event)
 {
     DialogyWidget::hideEvent(event);
 
+    // don't keep a transformed key around while nobody is about to unlock
+    resetKeyDerivation();
+
 #ifdef WITH_XC_YUBIKEY
     // Don't listen to any Yubikey events if we are hidden
     disconnect(YubiKey::instance(), nullptr, this, nullptr);
@@ -144,6 +174,16 @@ void DatabaseOpenWidget::load(const QString& filename)
     QHash<QString, QVariant> useTouchID = config()->get("UseTouchID").toHash();
     m_ui->checkTouchID->setChecked(useTouchID.value(m_filename, false).toBool());
 
+    // the KDF parameters are stored unencrypted in the header, which allows
+    // transforming the key before the user confirms it
+    resetKeyDerivation();
+    m_keyDerivationCount = 0;
+    QFile file(m_filename);
+    if (file.open(QIODevice::ReadOnly)) {
+        KeePass2Reader reader;
+        m_kdf = reader.readKdf(&file);
+    }
+
     m_ui->editPassword->setFocus();
 }
 
@@ -157,6 +197,8 @@ void DatabaseOpenWidget::clearForms()
     m_ui->checkTouchID->setChecked(false);
     m_ui->buttonTogglePassword->setChecked(false);
     m_db = nullptr;
+    resetKeyDerivation();
+    m_kdf.reset();
 }
 
 Database* DatabaseOpenWidget::database()
@@ -164,6 +206,41 @@ Database* DatabaseOpenWidget::database()
     return m_db;
 }
 
+/**
+ * Open the database on the given scheduler instead of on the GUI thread, so
+ * several databases, e.g. the ones restored at startup, are unlocked
+ * concurrently. The result has to be handed back by finishScheduledOpen().
+ */
+void DatabaseOpenWidget::setOpenScheduler(DatabaseOpenScheduler* scheduler)
+{
+    m_openScheduler = scheduler;
+}
+
+/**
+ * @return true if the database is being opened on the scheduler
+ */
+bool DatabaseOpenWidget::isOpenPending() const
+{
+    return m_openPending;
+}
+
+/**
+ * Finish opening the database on the scheduler. Takes ownership of db.
+ *
+ * @param db opened database or nullptr on failure
+ * @param errorString reason of the failure
+ */
+void DatabaseOpenWidget::finishScheduledOpen(Database* db, const QString& errorString)
+{
+    setOpenPending(false);
+    m_db = db;
+    if (m_db) {
+        databaseOpened();
+    } else {
+        databaseOpenFailed(errorString);
+    }
+}
+
 void DatabaseOpenWidget::enterKey(const QString& pw, const QString& keyFile)
 {
     if (!pw.isNull()) {
@@ -178,6 +255,10 @@ void DatabaseOpenWidget::enterKey(const QString& pw, const QString& keyFile)
 
 void DatabaseOpenWidget::openDatabase()
 {
+    if (m_openPending) {
+        return;
+    }
+
     KeePass2Reader reader;
     QSharedPointer<CompositeKey> masterKey = databaseKey();
     if (masterKey.isNull()) {
@@ -197,43 +278,101 @@ void DatabaseOpenWidget::openDatabase()
     }
 
     delete m_db;
+    m_db = nullptr;
 
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+    // reuse the key transformed in the background if it was derived from the same key inputs
+    bool challengeInKdf = m_kdf && m_kdf->uuid() != KeePass2::KDF_AES_KDBX3;
+    if (m_kdf && !(challengeInKdf && !masterKey->challengeResponseKeys().isEmpty())) {
+        if (m_keyDerivationRunning && m_keyDerivationCurrent) {
+            m_keyDerivationWatcher.waitForFinished();
+            keyDerivationFinished();
+        }
+        // the key file may have changed since, so compare the actual key
+        if (m_derivedKey && m_derivedKey->rawKey == masterKey->rawKey()) {
+            masterKey->setTransformedKey(*m_kdf, m_derivedKey->transformedKey);
+        }
+    }
+
+    // challenge-response keys talk to the hardware token, which stays on the GUI thread
+    const QString canonicalFilePath = QFileInfo(m_filename).canonicalFilePath();
+    if (m_openScheduler && masterKey->challengeResponseKeys().isEmpty()
+        && !m_openScheduler->isPending(canonicalFilePath)) {
+        QApplication::restoreOverrideCursor();
+        setOpenPending(true);
+        m_openScheduler->open(canonicalFilePath, masterKey);
+        return;
+    }
+
     m_db = reader.readDatabase(&file, masterKey);
     QApplication::restoreOverrideCursor();
 
     if (m_db) {
+        databaseOpened();
+    } else {
+        databaseOpenFailed(reader.errorString());
+    }
+}
+
+void DatabaseOpenWidget::databaseOpened()
+{
+    resetKeyDerivation();
+
 #ifdef WITH_XC_TOUCHID
-        QHash<QString, QVariant> useTouchID = config()->get("UseTouchID").toHash();
+    QHash<QString, QVariant> useTouchID = config()->get("UseTouchID").toHash();
 
-        // check if TouchID can & should be used to unlock the database next time
-        if (m_ui->checkTouchID->isChecked() && TouchID::getInstance().isAvailable()) {
-            // encrypt and store key blob
-            if (TouchID::getInstance().storeKey(m_filename, PasswordKey(m_ui->editPassword->text()).rawKey())) {
-                useTouchID.insert(m_filename, true);
-            }
-        } else {
-            // when TouchID not available or unchecked, reset for the current database
-            TouchID::getInstance().reset(m_filename);
-            useTouchID.insert(m_filename, false);
+    // check if TouchID can & should be used to unlock the database next time
+    if (m_ui->checkTouchID->isChecked() && TouchID::getInstance().isAvailable()) {
+        // encrypt and store key blob
+        if (TouchID::getInstance().storeKey(m_filename, PasswordKey(m_ui->editPassword->text()).rawKey())) {
+            useTouchID.insert(m_filename, true);
         }
+    } else {
+        // when TouchID not available or unchecked, reset for the current database
+        TouchID::getInstance().reset(m_filename);
+        useTouchID.insert(m_filename, false);
+    }
 
-        config()->set("UseTouchID", useTouchID);
+    config()->set("UseTouchID", useTouchID);
 #endif
 
-        if (m_ui->messageWidget->isVisible()) {
-            m_ui->messageWidget->animatedHide();
-        }
-        emit editFinished(true);
-    } else {
-        m_ui->messageWidget->showMessage(tr("Unable to open the database.").append("\n").append(reader.errorString()),
-                                         MessageWidget::Error);
-        m_ui->editPassword->clear();
+    if (m_ui->messageWidget->isVisible()) {
+        m_ui->messageWidget->animatedHide();
+    }
+    emit editFinished(true);
+}
+
+void DatabaseOpenWidget::databaseOpenFailed(const QString& errorString)
+{
+    m_ui->messageWidget->showMessage(tr("Unable to open the database.").append("\n").append(errorString),
+                                     MessageWidget::Error);
+    m_ui->editPassword->clear();
 
 #ifdef WITH_XC_TOUCHID
-        // unable to unlock database, reset TouchID for the current database
-        TouchID::getInstance().reset(m_filename);
+    // unable to unlock database, reset TouchID for the current database
+    TouchID::getInstance().reset(m_filename);
 #endif
+}
+
+/**
+ * Lock the key inputs while the database is opened on the scheduler. The
+ * form can still be cancelled, the result is discarded then.
+ */
+void DatabaseOpenWidget::setOpenPending(bool pending)
+{
+    m_openPending = pending;
+    m_ui->editPassword->setEnabled(!pending);
+    m_ui->buttonTogglePassword->setEnabled(!pending);
+    m_ui->comboKeyFile->setEnabled(!pending);
+    m_ui->buttonBrowseFile->setEnabled(!pending);
+    m_ui->checkPassword->setEnabled(!pending);
+    m_ui->checkKeyFile->setEnabled(!pending);
+    m_ui->checkChallengeResponse->setEnabled(!pending);
+    m_ui->checkTouchID->setEnabled(!pending);
+    m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!pending);
+    if (!pending) {
+        m_ui->editPassword->setFocus();
     }
 }
 
@@ -324,8 +463,111 @@ QSharedPointer<CompositeKey> DatabaseOpenWidget::databaseKey()
     return masterKey;
 }
 
+DatabaseOpenWidget::DerivedKey::~DerivedKey()
+{
+    // overwrite the key material before the memory is released
+    rawKey.fill('\0');
+    transformedKey.fill('\0');
+}
+
+/**
+ * Transform the key entered so far in the background. This has no side
+ * effects: it does not show any dialogs or messages, does not update the
+ * config and does not issue challenges. Only one transformation runs at a
+ * time; if the inputs changed in the meantime, the running one is discarded
+ * when it finishes and the new inputs are transformed instead.
+ */
+void DatabaseOpenWidget::deriveKey()
+{
+    if (!m_kdf || !isVisible() || m_derivedKey) {
+        return;
+    }
+
+    if (m_keyDerivationRunning) {
+        m_keyDerivationRequested = !m_keyDerivationCurrent;
+        return;
+    }
+
+    // KDBX4 KDFs include the challenge-response in the transformation,
+    // which must not be issued before the user confirms the unlock
+    if (m_ui->checkChallengeResponse->isChecked() && m_kdf->uuid() != KeePass2::KDF_AES_KDBX3) {
+        return;
+    }
+
+    const bool usePassword = m_ui->checkPassword->isChecked();
+    const bool useKeyFile = m_ui->checkKeyFile->isChecked();
+    // a KDBX3 challenge-response-only key transforms an empty static key
+    if (!usePassword && !useKeyFile && !m_ui->checkChallengeResponse->isChecked()) {
+        return;
+    }
+
+    if (m_keyDerivationCount >= MAX_SPECULATIVE_KEY_DERIVATIONS) {
+        return;
+    }
+    ++m_keyDerivationCount;
+
+    const QString password = m_ui->editPassword->text();
+    const QString keyFile = m_ui->comboKeyFile->currentText();
+    const QSharedPointer<Kdf> kdf = m_kdf->clone();
+
+    m_keyDerivationRunning = true;
+    m_keyDerivationCurrent = true;
+    m_keyDerivationRequested = false;
+    m_keyDerivationWatcher.setFuture(QtConcurrent::run([=]() {
+        CompositeKey key;
+        if (usePassword) {
+            key.addKey(QSharedPointer<PasswordKey>::create(password));
+        }
+        if (useKeyFile) {
+            auto fileKey = QSharedPointer<FileKey>::create();
+            if (!fileKey->load(keyFile)) {
+                return QSharedPointer<DerivedKey>();
+            }
+            key.addKey(fileKey);
+        }
+
+        auto derivedKey = QSharedPointer<DerivedKey>::create();
+        derivedKey->rawKey = key.rawKey();
+        if (!key.transform(*kdf, derivedKey->transformedKey)) {
+            return QSharedPointer<DerivedKey>();
+        }
+        return derivedKey;
+    }));
+}
+
+void DatabaseOpenWidget::keyDerivationFinished()
+{
+    // the result may already have been collected by openDatabase()
+    if (!m_keyDerivationRunning) {
+        return;
+    }
+    m_keyDerivationRunning = false;
+
+    // a superseded result is wiped once the future releases it as well
+    if (m_keyDerivationCurrent) {
+        m_derivedKey = m_keyDerivationWatcher.result();
+    }
+    m_keyDerivationCurrent = false;
+
+    if (m_keyDerivationRequested) {
+        m_keyDerivationRequested = false;
+        deriveKey();
+    }
+}
+
+/**
+ * Discard the derived key and the result of a running transformation.
+ */
+void DatabaseOpenWidget::resetKeyDerivation()
+{
+    m_derivedKey.reset();
+    m_keyDerivationCurrent = false;
+    m_keyDerivationRequested = false;
+}
+
 void DatabaseOpenWidget::reject()
 {
+    resetKeyDerivation();
     emit editFinished(false);
 }
 
@@ -354,6 +596,7 @@ void DatabaseOpenWidget::browseKeyFile()
 
     if (!filename.isEmpty()) {
         m_ui->comboKeyFile->lineEdit()->setText(filename);
+        deriveKey();
     }
 }
 
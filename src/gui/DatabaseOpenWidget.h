@@ -19,12 +19,15 @@
 #ifndef KEEPASSX_DATABASEOPENWIDGET_H
 #define KEEPASSX_DATABASEOPENWIDGET_H
 
+#include <QFutureWatcher>
+#include <QPointer>
 #include <QScopedPointer>
 
 #include "gui/DialogyWidget.h"
 #include "keys/CompositeKey.h"
 
 class Database;
+class DatabaseOpenScheduler;
 class QFile;
 
 namespace Ui
@@ -43,6 +46,9 @@ public:
     void clearForms();
     void enterKey(const QString& pw, const QString& keyFile);
     Database* database();
+    void setOpenScheduler(DatabaseOpenScheduler* scheduler);
+    bool isOpenPending() const;
+    void finishScheduledOpen(Database* db, const QString& errorString);
 
 public slots:
     void pollYubikey();
@@ -67,6 +73,9 @@ private slots:
     void yubikeyDetected(int slot, bool blocking);
     void yubikeyDetectComplete();
     void noYubikeyFound();
+    void deriveKey();
+    void keyDerivationFinished();
+    void resetKeyDerivation();
 
 protected:
     const QScopedPointer<Ui::DatabaseOpenWidget> m_ui;
@@ -74,7 +83,34 @@ protected:
     QString m_filename;
 
 private:
+    void databaseOpened();
+    void databaseOpenFailed(const QString& errorString);
+    void setOpenPending(bool pending);
+
+    /** Result of a speculative key transformation, overwritten when released. */
+    struct DerivedKey
+    {
+        ~DerivedKey();
+
+        QByteArray rawKey;
+        QByteArray transformedKey;
+    };
+
     bool m_yubiKeyBeingPolled = false;
+
+    // opening in the background, see setOpenScheduler()
+    QPointer<DatabaseOpenScheduler> m_openScheduler;
+    bool m_openPending;
+
+    // speculative background key derivation
+    QSharedPointer<Kdf> m_kdf;
+    QFutureWatcher<QSharedPointer<DerivedKey>> m_keyDerivationWatcher;
+    QSharedPointer<DerivedKey> m_derivedKey;
+    bool m_keyDerivationRunning;
+    bool m_keyDerivationCurrent;
+    bool m_keyDerivationRequested;
+    int m_keyDerivationCount;
+
     Q_DISABLE_COPY(DatabaseOpenWidget)
 };
 
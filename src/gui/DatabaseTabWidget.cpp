@@ -26,6 +26,7 @@
 #include "core/AsyncTask.h"
 #include "core/Config.h"
 #include "core/Database.h"
+#include "core/DatabaseOpenScheduler.h"
 #include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -40,6 +41,8 @@
 #include "gui/entry/EntryView.h"
 #include "gui/group/GroupView.h"
 #include "gui/wizard/NewDatabaseWizard.h"
+#include "keys/FileKey.h"
+#include "keys/PasswordKey.h"
 
 DatabaseManagerStruct::DatabaseManagerStruct()
     : dbWidget(nullptr)
@@ -55,7 +58,16 @@ DatabaseTabWidget::DatabaseTabWidget(QWidget* parent)
     : QTabWidget(parent)
     , m_dbWidgetStateSync(new DatabaseWidgetStateSync(this))
     , m_dbPendingLock(nullptr)
+    , m_openScheduler(new DatabaseOpenScheduler(this))
 {
+    m_openScheduler->setMemoryBudget(config()->get("ConcurrentOpenMemoryBudget").toULongLong() * 1024);
+    connect(m_openScheduler,
+            SIGNAL(databaseOpened(QString,Database*)),
+            SLOT(scheduledDatabaseOpened(QString,Database*)));
+    connect(m_openScheduler,
+            SIGNAL(databaseOpenFailed(QString,QString)),
+            SLOT(scheduledDatabaseOpenFailed(QString,QString)));
+
     DragTabBar* tabBar = new DragTabBar(this);
     setTabBar(tabBar);
     setDocumentMode(true);
@@ -157,7 +169,8 @@ void DatabaseTabWidget::openDatabase(const QString& fileName, const QString& pw,
     while (i.hasNext()) {
         i.next();
         if (i.value().fileInfo.canonicalFilePath() == canonicalFilePath) {
-            if (!i.value().dbWidget->dbHasKey() && !(pw.isNull() && keyFile.isEmpty())) {
+            if (!i.value().dbWidget->dbHasKey() && !(pw.isNull() && keyFile.isEmpty())
+                && !m_openScheduler->isPending(canonicalFilePath)) {
                 // If the database is locked and a pw or keyfile is provided, unlock it
                 i.value().dbWidget->switchToOpenDatabase(i.value().fileInfo.absoluteFilePath(), pw, keyFile);
             } else {
@@ -196,15 +209,74 @@ void DatabaseTabWidget::openDatabase(const QString& fileName, const QString& pw,
 
     updateLastDatabases(dbStruct.fileInfo.absoluteFilePath());
 
+    // the key entered in the open form is applied in the background as well,
+    // so the databases restored at startup can be unlocked one after another
+    // without waiting for each of them
+    dbStruct.dbWidget->setOpenScheduler(m_openScheduler);
+    dbStruct.dbWidget->switchToOpenDatabase(dbStruct.fileInfo.absoluteFilePath());
+
     if (!pw.isNull() || !keyFile.isEmpty()) {
-        dbStruct.dbWidget->switchToOpenDatabase(dbStruct.fileInfo.absoluteFilePath(), pw, keyFile);
-    } else {
-        dbStruct.dbWidget->switchToOpenDatabase(dbStruct.fileInfo.absoluteFilePath());
+        // open in the background, so several databases (e.g. AutoOpen or
+        // multiple files on the command line) are unlocked concurrently
+        auto key = QSharedPointer<CompositeKey>::create();
+        if (!pw.isNull()) {
+            key->addKey(QSharedPointer<PasswordKey>::create(pw));
+        }
+        if (!keyFile.isEmpty()) {
+            auto fileKey = QSharedPointer<FileKey>::create();
+            QString errorMsg;
+            if (!fileKey->load(keyFile, &errorMsg)) {
+                emit messageTab(tr("Can't open key file:\n%1").arg(errorMsg), MessageWidget::Error);
+                return;
+            }
+            key->addKey(fileKey);
+        }
+        m_openScheduler->open(canonicalFilePath, key);
     }
 
     emit messageDismissTab();
 }
 
+void DatabaseTabWidget::scheduledDatabaseOpened(const QString& filePath, Database* db)
+{
+    DatabaseWidget* dbWidget = databaseWidgetForFile(filePath);
+    if (!dbWidget || dbWidget->dbHasKey()) {
+        // tab was closed or the database has been unlocked manually in the meantime
+        delete db;
+        return;
+    }
+
+    if (!dbWidget->finishScheduledOpenDatabase(db, QString())) {
+        dbWidget->finishOpenDatabase(db);
+    }
+}
+
+void DatabaseTabWidget::scheduledDatabaseOpenFailed(const QString& filePath, const QString& errorString)
+{
+    DatabaseWidget* dbWidget = databaseWidgetForFile(filePath);
+    if (!dbWidget || dbWidget->dbHasKey() || dbWidget->finishScheduledOpenDatabase(nullptr, errorString)) {
+        return;
+    }
+
+    // leave the tab at the unlock form so the user can enter the key manually
+    emit messageGlobal(tr("Unable to open the database %1.").arg(filePath).append("\n").append(errorString),
+                       MessageWidget::Error);
+}
+
+/**
+ * @param filePath canonical database file path
+ * @return widget of the open tab for filePath, nullptr if there is none
+ */
+DatabaseWidget* DatabaseTabWidget::databaseWidgetForFile(const QString& filePath)
+{
+    for (const auto& dbStruct : asConst(m_dbList)) {
+        if (dbStruct.fileInfo.canonicalFilePath() == filePath) {
+            return dbStruct.dbWidget;
+        }
+    }
+    return nullptr;
+}
+
 void DatabaseTabWidget::importCsv()
 {
     QString filter = QString("%1 (*.csv);;%2 (*)").arg(tr("CSV file"), tr("All files"));
@@ -510,6 +582,11 @@ void DatabaseTabWidget::changeDatabaseSettings()
     currentDatabaseWidget()->switchToDatabaseSettings();
 }
 
+void DatabaseTabWidget::showPasswordHealthReport()
+{
+    currentDatabaseWidget()->showPasswordHealthReport();
+}
+
 bool DatabaseTabWidget::readOnly(int index)
 {
     if (index == -1) {
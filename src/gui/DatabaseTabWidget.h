@@ -26,6 +26,7 @@
 #include "gui/DatabaseWidget.h"
 #include "gui/MessageWidget.h"
 
+class DatabaseOpenScheduler;
 class DatabaseWidget;
 class DatabaseWidgetStateSync;
 class DatabaseOpenWidget;
@@ -74,6 +75,7 @@ public slots:
     bool closeAllDatabases();
     void changeMasterKey();
     void changeDatabaseSettings();
+    void showPasswordHealthReport();
     bool readOnly(int index = -1);
     bool canSave(int index = -1);
     bool isModified(int index = -1);
@@ -102,6 +104,8 @@ private slots:
     void changeDatabase(Database* newDb, bool unsavedChanges);
     void emitActivateDatabaseChanged();
     void emitDatabaseUnlockedFromDbWidgetSender();
+    void scheduledDatabaseOpened(const QString& filePath, Database* db);
+    void scheduledDatabaseOpenFailed(const QString& filePath, const QString& errorString);
 
 private:
     Database* execNewDatabaseWizard();
@@ -115,10 +119,12 @@ private:
     void insertDatabase(Database* db, const DatabaseManagerStruct& dbStruct);
     void updateLastDatabases(const QString& filename);
     void connectDatabase(Database* newDb, Database* oldDb = nullptr);
+    DatabaseWidget* databaseWidgetForFile(const QString& filePath);
 
     QHash<Database*, DatabaseManagerStruct> m_dbList;
     QPointer<DatabaseWidgetStateSync> m_dbWidgetStateSync;
     QPointer<DatabaseWidget> m_dbPendingLock;
+    DatabaseOpenScheduler* m_openScheduler;
 };
 
 #endif // KEEPASSX_DATABASETABWIDGET_H
@@ -32,6 +32,7 @@
 #include <QSplitter>
 
 #include "autotype/AutoType.h"
+#include "core/AsyncTask.h"
 #include "core/Config.h"
 #include "core/EntrySearcher.h"
 #include "core/FilePath.h"
@@ -49,6 +50,7 @@
 #include "gui/MessageBox.h"
 #include "gui/TotpSetupDialog.h"
 #include "gui/TotpDialog.h"
+#include "gui/PasswordHealthDialog.h"
 #include "gui/TotpExportSettingsDialog.h"
 #include "gui/UnlockDatabaseDialog.h"
 #include "gui/UnlockDatabaseWidget.h"
@@ -68,6 +70,22 @@
 #include "sshagent/SSHAgent.h"
 #endif
 
+namespace
+{
+    /**
+     * Create the base for a three-way merge on reload, if enabled. This hashes
+     * every entry, so it is done off the GUI thread while the database is not
+     * shown or modified yet.
+     */
+    QByteArray createMergeBase(const Database* db)
+    {
+        if (!config()->get("ThreeWayMergeOnReload").toBool()) {
+            return QByteArray();
+        }
+        return AsyncTask::runAndWaitForFuture([db]() { return Merger::createBaseManifest(db); });
+    }
+} // namespace
+
 DatabaseWidget::DatabaseWidget(Database* db, QWidget* parent)
     : QStackedWidget(parent)
     , m_db(db)
@@ -471,9 +489,16 @@ void DatabaseWidget::deleteEntries()
             this, tr("Delete entry(s)?", "", selected.size()), prompt, QMessageBox::Yes | QMessageBox::No);
 
         if (result == QMessageBox::Yes) {
+            const bool bulkUpdate = selectedEntries.size() > 1;
+            if (bulkUpdate) {
+                m_db->beginBulkUpdate();
+            }
             for (Entry* entry : asConst(selectedEntries)) {
                 delete entry;
             }
+            if (bulkUpdate) {
+                m_db->endBulkUpdate();
+            }
             refreshSearch();
         }
     } else {
@@ -492,9 +517,16 @@ void DatabaseWidget::deleteEntries()
             return;
         }
 
+        const bool bulkUpdate = selectedEntries.size() > 1;
+        if (bulkUpdate) {
+            m_db->beginBulkUpdate();
+        }
         for (Entry* entry : asConst(selectedEntries)) {
             m_db->recycleEntry(entry);
         }
+        if (bulkUpdate) {
+            m_db->endBulkUpdate();
+        }
     }
 }
 
@@ -582,6 +614,17 @@ void DatabaseWidget::showTotpKeyQrCode()
     totpDisplayDialog->open();
 }
 
+void DatabaseWidget::showPasswordHealthReport()
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const QList<PasswordHealth::Item> items = m_passwordHealth.analyze(m_db);
+    QApplication::restoreOverrideCursor();
+
+    auto healthDialog = new PasswordHealthDialog(this, items);
+    connect(healthDialog, SIGNAL(entryActivated(Entry*)), SLOT(switchToEntryEdit(Entry*)));
+    healthDialog->show();
+}
+
 void DatabaseWidget::setClipboardTextAndMinimize(const QString& text)
 {
     clipboard()->setText(text);
@@ -818,17 +861,7 @@ void DatabaseWidget::switchToGroupEdit(Group* group, bool create)
 void DatabaseWidget::openDatabase(bool accepted)
 {
     if (accepted) {
-        replaceDatabase(static_cast<DatabaseOpenWidget*>(sender())->database());
-        setCurrentWidget(m_mainWidget);
-        emit unlockedDatabase();
-
-        // We won't need those anymore and KeePass1OpenWidget closes
-        // the file in its dtor.
-        delete m_databaseOpenWidget;
-        m_databaseOpenWidget = nullptr;
-        delete m_keepass1OpenWidget;
-        m_keepass1OpenWidget = nullptr;
-        m_fileWatcher.addPath(m_filePath);
+        finishOpenDatabase(static_cast<DatabaseOpenWidget*>(sender())->database());
     } else {
         m_fileWatcher.removePath(m_filePath);
         if (m_databaseOpenWidget->database()) {
@@ -838,6 +871,55 @@ void DatabaseWidget::openDatabase(bool accepted)
     }
 }
 
+/**
+ * Show a database that has been opened for this widget, e.g. by the
+ * open widget or in the background. Takes ownership of db.
+ *
+ * @param db opened database
+ */
+void DatabaseWidget::finishOpenDatabase(Database* db)
+{
+    m_mergeBase = createMergeBase(db);
+    replaceDatabase(db);
+    setCurrentWidget(m_mainWidget);
+    emit unlockedDatabase();
+
+    // We won't need those anymore and KeePass1OpenWidget closes
+    // the file in its dtor.
+    delete m_databaseOpenWidget;
+    m_databaseOpenWidget = nullptr;
+    delete m_keepass1OpenWidget;
+    m_keepass1OpenWidget = nullptr;
+    m_fileWatcher.addPath(m_filePath);
+}
+
+/**
+ * Let the open form unlock the database on the given scheduler, see
+ * DatabaseOpenWidget::setOpenScheduler().
+ */
+void DatabaseWidget::setOpenScheduler(DatabaseOpenScheduler* scheduler)
+{
+    if (m_databaseOpenWidget) {
+        m_databaseOpenWidget->setOpenScheduler(scheduler);
+    }
+}
+
+/**
+ * Hand the result of opening the database on the scheduler to the open form
+ * that requested it. Takes ownership of db if it returns true.
+ *
+ * @return false if the open form did not request it
+ */
+bool DatabaseWidget::finishScheduledOpenDatabase(Database* db, const QString& errorString)
+{
+    if (!m_databaseOpenWidget || !m_databaseOpenWidget->isOpenPending()) {
+        return false;
+    }
+
+    m_databaseOpenWidget->finishScheduledOpen(db, errorString);
+    return true;
+}
+
 void DatabaseWidget::mergeDatabase(bool accepted)
 {
     if (accepted) {
@@ -854,6 +936,7 @@ void DatabaseWidget::mergeDatabase(bool accepted)
         }
 
         Merger merger(srcDb, m_db);
+        merger.setConcurrentPlanning(true);
         merger.merge();
     }
 
@@ -1182,6 +1265,7 @@ void DatabaseWidget::lock()
     Database* newDb = new Database();
     newDb->metadata()->setName(m_db->metadata()->name());
     replaceDatabase(newDb);
+    m_passwordHealth.clearCache();
     emit lockedDatabase();
 }
 
@@ -1271,6 +1355,7 @@ void DatabaseWidget::reloadDatabaseFile()
     if (file.open(QIODevice::ReadOnly)) {
         Database* db = reader.readDatabase(&file, database()->key());
         if (db != nullptr) {
+            const QByteArray fileMergeBase = createMergeBase(db);
             if (m_databaseModified) {
                 // Ask if we want to merge changes into new database
                 QMessageBox::StandardButton mb =
@@ -1284,6 +1369,11 @@ void DatabaseWidget::reloadDatabaseFile()
                     // Merge the old database into the new one
                     m_db->setEmitModified(false);
                     Merger merger(m_db, db);
+                    merger.setConcurrentPlanning(true);
+                    if (config()->get("ThreeWayMergeOnReload").toBool()) {
+                        // local entries unchanged since the last load are already in the file
+                        merger.setBaseManifest(m_mergeBase);
+                    }
                     merger.merge();
                 } else {
                     // Since we are accepting the new file as-is, internally mark as unmodified
@@ -1305,6 +1395,7 @@ void DatabaseWidget::reloadDatabaseFile()
             }
 
             replaceDatabase(db);
+            m_mergeBase = fileMergeBase;
             restoreGroupEntryFocus(groupBeforeReload, entryBeforeReload);
         }
     } else {
@@ -25,11 +25,13 @@
 #include <QTimer>
 
 #include "gui/entry/EntryModel.h"
+#include "core/PasswordHealth.h"
 #include "gui/MessageWidget.h"
 #include "gui/csvImport/CsvImportWizard.h"
 #include "gui/entry/EntryModel.h"
 
 class ChangeMasterKeyWidget;
+class DatabaseOpenScheduler;
 class DatabaseOpenWidget;
 class DatabaseSettingsDialog;
 class Database;
@@ -82,6 +84,9 @@ public:
     void setCurrentWidget(QWidget* widget);
     DatabaseWidget::Mode currentMode() const;
     void lock();
+    void finishOpenDatabase(Database* db);
+    void setOpenScheduler(DatabaseOpenScheduler* scheduler);
+    bool finishScheduledOpenDatabase(Database* db, const QString& errorString);
     void updateFilePath(const QString& filePath);
     int numberOfSelectedEntries() const;
     QStringList customEntryAttributes() const;
@@ -152,6 +157,7 @@ public slots:
     void copyAttribute(QAction* action);
     void showTotp();
     void showTotpKeyQrCode();
+    void showPasswordHealthReport();
     void copyTotp();
     void setupTotp();
     void performAutoType();
@@ -259,6 +265,10 @@ private:
     QTimer m_fileWatchUnblockTimer;
     bool m_ignoreAutoReload;
     bool m_databaseModified;
+    // state of the database file when it was loaded, base of three-way merges on reload
+    QByteArray m_mergeBase;
+    // password estimates of the last health report, reused by the next one
+    PasswordHealth m_passwordHealth;
 };
 
 #endif // KEEPASSX_DATABASEWIDGET_H
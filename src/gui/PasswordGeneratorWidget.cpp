@@ -22,21 +22,30 @@
 #include <QDir>
 #include <QKeyEvent>
 #include <QLineEdit>
+#include <QtConcurrent>
 
 #include "core/Config.h"
 #include "core/FilePath.h"
 #include "core/PasswordGenerator.h"
 #include "gui/Clipboard.h"
 
+#include <zxcvbn.h>
+
 PasswordGeneratorWidget::PasswordGeneratorWidget(QWidget* parent)
     : QWidget(parent)
     , m_updatingSpinBox(false)
     , m_passwordGenerator(new PasswordGenerator())
     , m_dicewareGenerator(new PassphraseGenerator())
     , m_ui(new Ui::PasswordGeneratorWidget())
+    , m_strengthTimer(new QTimer(this))
+    , m_strengthWatcher(new QFutureWatcher<double>(this))
 {
     m_ui->setupUi(this);
 
+    m_strengthTimer->setSingleShot(true);
+    connect(m_strengthTimer, SIGNAL(timeout()), SLOT(estimatePasswordStrength()));
+    connect(m_strengthWatcher, SIGNAL(finished()), SLOT(passwordStrengthEstimated()));
+
     m_ui->togglePasswordButton->setIcon(filePath()->onOffIcon("actions", "password-show"));
 
     connect(m_ui->editNewPassword, SIGNAL(textChanged(QString)), SLOT(updateButtonsEnabled(QString)));
@@ -245,13 +254,52 @@ void PasswordGeneratorWidget::updateButtonsEnabled(const QString& password)
 
 void PasswordGeneratorWidget::updatePasswordStrength(const QString& password)
 {
-    double entropy = 0.0;
+    m_strengthTimer->stop();
+    m_pendingPassword = password;
+
     if (m_ui->tabWidget->currentIndex() == Password) {
-        entropy = m_passwordGenerator->calculateEntropy(password);
+        if (password.length() > MaxImmediateEstimateLength) {
+            // The estimate grows quadratically with the length, so wait for
+            // typing to pause and keep the GUI thread responsive meanwhile
+            m_strengthTimer->start(100);
+            return;
+        }
+        showPasswordStrength(m_passwordGenerator->calculateEntropy(password));
     } else {
-        entropy = m_dicewareGenerator->calculateEntropy(password);
+        showPasswordStrength(m_dicewareGenerator->calculateEntropy(password));
+    }
+}
+
+void PasswordGeneratorWidget::estimatePasswordStrength()
+{
+    if (m_strengthWatcher->isRunning()) {
+        // passwordStrengthEstimated() picks up the latest password
+        return;
+    }
+
+    m_estimatingPassword = m_pendingPassword;
+    const QByteArray password = m_estimatingPassword.toLatin1();
+    m_strengthWatcher->setFuture(QtConcurrent::run([password]() {
+        return ZxcvbnMatch(password.constData(), nullptr, nullptr);
+    }));
+}
+
+void PasswordGeneratorWidget::passwordStrengthEstimated()
+{
+    const bool current = m_estimatingPassword == m_pendingPassword;
+    m_estimatingPassword.clear();
+
+    if (current) {
+        showPasswordStrength(m_strengthWatcher->result());
+    } else if (!m_strengthTimer->isActive() && m_pendingPassword.length() > MaxImmediateEstimateLength
+               && m_ui->tabWidget->currentIndex() == Password) {
+        // The password changed while estimating and its delay already expired
+        estimatePasswordStrength();
     }
+}
 
+void PasswordGeneratorWidget::showPasswordStrength(double entropy)
+{
     m_ui->entropyLabel->setText(tr("Entropy: %1 bit").arg(QString::number(entropy, 'f', 2)));
 
     if (entropy > m_ui->entropyProgressBar->maximum()) {
@@ -20,7 +20,9 @@
 #define KEEPASSX_PASSWORDGENERATORWIDGET_H
 
 #include <QComboBox>
+#include <QFutureWatcher>
 #include <QLabel>
+#include <QTimer>
 #include <QWidget>
 
 #include "core/PassphraseGenerator.h"
@@ -75,6 +77,8 @@ private slots:
     void dicewareSliderMoved();
     void dicewareSpinBoxChanged();
     void colorStrengthIndicator(double entropy);
+    void estimatePasswordStrength();
+    void passwordStrengthEstimated();
 
     void updateGenerator();
 
@@ -84,11 +88,20 @@ private:
 
     PasswordGenerator::CharClasses charClasses();
     PasswordGenerator::GeneratorFlags generatorFlags();
+    void showPasswordStrength(double entropy);
 
     const QScopedPointer<PasswordGenerator> m_passwordGenerator;
     const QScopedPointer<PassphraseGenerator> m_dicewareGenerator;
     const QScopedPointer<Ui::PasswordGeneratorWidget> m_ui;
 
+    /** Passwords up to this length are estimated immediately, longer ones on a worker thread. */
+    static const int MaxImmediateEstimateLength = 64;
+
+    QTimer* const m_strengthTimer;
+    QFutureWatcher<double>* const m_strengthWatcher;
+    QString m_pendingPassword;
+    QString m_estimatingPassword;
+
 protected:
     void keyPressEvent(QKeyEvent* e) override;
 };
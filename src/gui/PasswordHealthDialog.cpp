@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordHealthDialog.h"
+
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QUuid>
+#include <QVBoxLayout>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "gui/DatabaseWidget.h"
+
+namespace
+{
+    enum Column
+    {
+        EntryColumn,
+        GroupColumn,
+        QualityColumn,
+        EntropyColumn,
+        UsedByColumn,
+        ExpiredColumn
+    };
+} // namespace
+
+PasswordHealthDialog::PasswordHealthDialog(DatabaseWidget* parent, const QList<PasswordHealth::Item>& items)
+    : QDialog(parent)
+    , m_db(parent->database())
+    , m_entryList(new QTreeWidget())
+{
+    setWindowTitle(tr("Password Health Report"));
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    m_entryList->setRootIsDecorated(false);
+    m_entryList->setUniformRowHeights(true);
+    m_entryList->setAlternatingRowColors(true);
+    m_entryList->setHeaderLabels({tr("Entry"), tr("Group"), tr("Quality"), tr("Entropy"), tr("Used by"), tr("Expired")});
+
+    int count = 0;
+    for (const PasswordHealth::Item& item : items) {
+        if (!item.hasProblems()) {
+            continue;
+        }
+        ++count;
+
+        auto* row = new QTreeWidgetItem(m_entryList);
+        row->setText(EntryColumn, item.entry->title());
+        row->setIcon(EntryColumn, item.entry->iconScaledPixmap());
+        row->setData(EntryColumn, Qt::UserRole, QVariant::fromValue(item.entry->uuid()));
+        row->setText(GroupColumn, item.entry->group()->hierarchy().mid(1).join("/"));
+        row->setText(QualityColumn, PasswordHealth::qualityName(item.quality));
+        // numeric data so the columns sort by value
+        row->setData(EntropyColumn, Qt::DisplayRole, qRound(item.entropy * 100) / 100.0);
+        row->setData(UsedByColumn, Qt::DisplayRole, item.reuseCount);
+        row->setText(ExpiredColumn, item.expired ? tr("Yes") : QString());
+    }
+
+    m_entryList->setSortingEnabled(true);
+    m_entryList->sortByColumn(EntropyColumn, Qt::AscendingOrder);
+    m_entryList->header()->resizeSections(QHeaderView::ResizeToContents);
+
+    auto* summary = new QLabel(tr("%1 of %2 entries have weak, empty or reused passwords or are expired.")
+                                   .arg(count)
+                                   .arg(items.size()));
+    summary->setWordWrap(true);
+
+    auto* buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+
+    auto* layout = new QVBoxLayout();
+    layout->addWidget(summary);
+    layout->addWidget(m_entryList);
+    layout->addWidget(buttonBox);
+    setLayout(layout);
+    resize(640, 400);
+
+    connect(buttonBox, SIGNAL(rejected()), SLOT(close()));
+    connect(m_entryList, SIGNAL(itemActivated(QTreeWidgetItem*,int)), SLOT(activateItem(QTreeWidgetItem*)));
+    connect(parent, SIGNAL(lockedDatabase()), SLOT(close()));
+}
+
+PasswordHealthDialog::~PasswordHealthDialog() = default;
+
+void PasswordHealthDialog::activateItem(QTreeWidgetItem* item)
+{
+    if (!m_db || !item) {
+        return;
+    }
+
+    // the entry may have been deleted since the report was created
+    Entry* entry = m_db->rootGroup()->findEntryByUuid(item->data(EntryColumn, Qt::UserRole).toUuid());
+    if (entry) {
+        emit entryActivated(entry);
+    }
+}
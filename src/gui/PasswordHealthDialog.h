@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_PASSWORDHEALTHDIALOG_H
+#define KEEPASSXC_PASSWORDHEALTHDIALOG_H
+
+#include <QDialog>
+#include <QPointer>
+
+#include "core/PasswordHealth.h"
+
+class Database;
+class DatabaseWidget;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * Lists the entries of a password health report that have problems.
+ * Activating an entry opens it for editing.
+ */
+class PasswordHealthDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    PasswordHealthDialog(DatabaseWidget* parent, const QList<PasswordHealth::Item>& items);
+    ~PasswordHealthDialog();
+
+signals:
+    void entryActivated(Entry* entry);
+
+private slots:
+    void activateItem(QTreeWidgetItem* item);
+
+private:
+    QPointer<Database> m_db;
+    QTreeWidget* m_entryList;
+};
+
+#endif // KEEPASSXC_PASSWORDHEALTHDIALOG_H
@@ -19,6 +19,7 @@
 
 SortFilterHideProxyModel::SortFilterHideProxyModel(QObject* parent)
     : QSortFilterProxyModel(parent)
+    , m_sortKeysRole(-1)
 {
 }
 
@@ -27,6 +28,34 @@ Qt::DropActions SortFilterHideProxyModel::supportedDragActions() const
     return sourceModel()->supportedDragActions();
 }
 
+void SortFilterHideProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+                   this, SLOT(sourceDataChanged(QModelIndex,QModelIndex)));
+        disconnect(this->sourceModel(), SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(clearSortKeys()));
+        disconnect(this->sourceModel(), SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(clearSortKeys()));
+        disconnect(this->sourceModel(), SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+                   this, SLOT(clearSortKeys()));
+        disconnect(this->sourceModel(), SIGNAL(layoutAboutToBeChanged()), this, SLOT(clearSortKeys()));
+        disconnect(this->sourceModel(), SIGNAL(modelAboutToBeReset()), this, SLOT(clearSortKeys()));
+    }
+    clearSortKeys();
+
+    // connect before the proxy does, so it never sorts with outdated keys
+    if (sourceModel) {
+        connect(sourceModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+                SLOT(sourceDataChanged(QModelIndex,QModelIndex)));
+        connect(sourceModel, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), SLOT(clearSortKeys()));
+        connect(sourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), SLOT(clearSortKeys()));
+        connect(sourceModel, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)), SLOT(clearSortKeys()));
+        connect(sourceModel, SIGNAL(layoutAboutToBeChanged()), SLOT(clearSortKeys()));
+        connect(sourceModel, SIGNAL(modelAboutToBeReset()), SLOT(clearSortKeys()));
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 void SortFilterHideProxyModel::hideColumn(int column, bool hide)
 {
     m_hiddenColumns.resize(column + 1);
@@ -41,3 +70,72 @@ bool SortFilterHideProxyModel::filterAcceptsColumn(int sourceColumn, const QMode
 
     return sourceColumn >= m_hiddenColumns.size() || !m_hiddenColumns.at(sourceColumn);
 }
+
+/**
+ * Compare the cached collation keys of string values instead of comparing the
+ * strings themselves. The sort value of each cell is fetched and collated
+ * only once until the source row changes, which turns sorting large lists
+ * from repeated placeholder resolution and locale aware comparisons into
+ * plain key comparisons.
+ */
+bool SortFilterHideProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    // the keys are cached by row, which identifies an item in flat models only
+    if (!isSortLocaleAware() || left.parent().isValid() || right.parent().isValid()) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    if (m_collator.caseSensitivity() != sortCaseSensitivity() || m_sortKeysRole != sortRole()) {
+        clearSortKeys();
+        m_collator.setCaseSensitivity(sortCaseSensitivity());
+        m_sortKeysRole = sortRole();
+    }
+
+    const QCollatorSortKey* leftKey = sortKey(left);
+    const QCollatorSortKey* rightKey = leftKey ? sortKey(right) : nullptr;
+    if (!leftKey || !rightKey) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+    return leftKey->compare(*rightKey) < 0;
+}
+
+const QCollatorSortKey* SortFilterHideProxyModel::sortKey(const QModelIndex& index) const
+{
+    const QPair<int, int> cell(index.row(), index.column());
+    auto it = m_sortKeys.constFind(cell);
+    if (it != m_sortKeys.constEnd()) {
+        return &it.value();
+    }
+    if (m_unkeyedCells.contains(cell)) {
+        return nullptr;
+    }
+
+    const QVariant value = sourceModel()->data(index, sortRole());
+    if (value.userType() != QMetaType::QString) {
+        m_unkeyedCells.insert(cell);
+        return nullptr;
+    }
+
+    return &m_sortKeys.insert(cell, m_collator.sortKey(value.toString())).value();
+}
+
+void SortFilterHideProxyModel::clearSortKeys()
+{
+    m_sortKeys.clear();
+    m_unkeyedCells.clear();
+}
+
+void SortFilterHideProxyModel::sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        clearSortKeys();
+        return;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+            m_sortKeys.remove(qMakePair(row, column));
+            m_unkeyedCells.remove(qMakePair(row, column));
+        }
+    }
+}
@@ -19,6 +19,9 @@
 #define KEEPASSX_SORTFILTERHIDEPROXYMODEL_H
 
 #include <QBitArray>
+#include <QCollator>
+#include <QHash>
+#include <QSet>
 #include <QSortFilterProxyModel>
 
 class SortFilterHideProxyModel : public QSortFilterProxyModel
@@ -28,13 +31,27 @@ class SortFilterHideProxyModel : public QSortFilterProxyModel
 public:
     explicit SortFilterHideProxyModel(QObject* parent = nullptr);
     Qt::DropActions supportedDragActions() const override;
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
     void hideColumn(int column, bool hide);
 
 protected:
     bool filterAcceptsColumn(int sourceColumn, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private slots:
+    void clearSortKeys();
+    void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
 
 private:
+    const QCollatorSortKey* sortKey(const QModelIndex& index) const;
+
     QBitArray m_hiddenColumns;
+    mutable QCollator m_collator;
+    mutable int m_sortKeysRole;
+    // collation keys of the string sort values by source row and column
+    mutable QHash<QPair<int, int>, QCollatorSortKey> m_sortKeys;
+    // source cells whose sort value is not a string
+    mutable QSet<QPair<int, int>> m_unkeyedCells;
 };
 
 #endif // KEEPASSX_SORTFILTERHIDEPROXYMODEL_H
@@ -237,6 +237,7 @@ QString CsvImportWidget::formatStatusText() const
 
 void CsvImportWidget::writeDatabase()
 {
+    m_db->beginBulkUpdate();
     setRootGroup();
     for (int r = 0; r < m_parserModel->rowCount(); ++r) {
         // use validity of second column as a GO/NOGO for all others fields
@@ -267,6 +268,8 @@ void CsvImportWidget::writeDatabase()
         }
         entry->setTimeInfo(timeInfo);
     }
+    m_db->endBulkUpdate();
+
     QBuffer buffer;
     buffer.open(QBuffer::ReadWrite);
 
@@ -21,6 +21,7 @@
 #include "core/Metadata.h"
 #include "core/Global.h"
 #include "core/AsyncTask.h"
+#include "core/Config.h"
 #include "gui/MessageBox.h"
 #include "crypto/kdf/Argon2Kdf.h"
 #include "format/KeePass2.h"
@@ -30,13 +31,31 @@
 
 const char* DatabaseSettingsWidgetEncryption::CD_DECRYPTION_TIME_PREFERENCE_KEY = "KPXC_DECRYPTION_TIME_PREFERENCE";
 
+namespace
+{
+    /**
+     * Benchmark the given KDF without blocking the event loop. Calibration
+     * results are persisted in the application config, so benchmarking a
+     * recently seen KDF configuration returns instantly unless a new
+     * measurement is requested.
+     */
+    int benchmarkKdf(const QSharedPointer<Kdf>& kdf, int msec, bool recalibrate = false)
+    {
+        Kdf::restoreCalibrationCache(config()->get("security/KdfCalibration").toMap());
+        int rounds =
+            AsyncTask::runAndWaitForFuture([&kdf, msec, recalibrate]() { return kdf->benchmark(msec, recalibrate); });
+        config()->set("security/KdfCalibration", Kdf::calibrationCache());
+        return rounds;
+    }
+} // namespace
+
 DatabaseSettingsWidgetEncryption::DatabaseSettingsWidgetEncryption(QWidget* parent)
     : DatabaseSettingsWidget(parent)
     , m_ui(new Ui::DatabaseSettingsWidgetEncryption())
 {
     m_ui->setupUi(this);
 
-    connect(m_ui->transformBenchmarkButton, SIGNAL(clicked()), SLOT(benchmarkTransformRounds()));
+    connect(m_ui->transformBenchmarkButton, SIGNAL(clicked()), SLOT(recalibrateTransformRounds()));
     connect(m_ui->kdfComboBox, SIGNAL(currentIndexChanged(int)), SLOT(changeKdf(int)));
 
     connect(m_ui->memorySpinBox, SIGNAL(valueChanged(int)), this, SLOT(memoryChanged(int)));
@@ -227,8 +246,7 @@ bool DatabaseSettingsWidgetEncryption::save()
 
         QApplication::setOverrideCursor(Qt::BusyCursor);
 
-        int rounds = AsyncTask::runAndWaitForFuture([&kdf, time]() { return kdf->benchmark(time); });
-        kdf->setRounds(rounds);
+        kdf->setRounds(benchmarkKdf(kdf, time));
 
         // TODO: we should probably use AsyncTask::runAndWaitForFuture() here,
         //       but not without making Database thread-safe
@@ -301,7 +319,7 @@ bool DatabaseSettingsWidgetEncryption::save()
     return ok;
 }
 
-void DatabaseSettingsWidgetEncryption::benchmarkTransformRounds(int millisecs)
+void DatabaseSettingsWidgetEncryption::benchmarkTransformRounds(int millisecs, bool recalibrate)
 {
     QApplication::setOverrideCursor(Qt::BusyCursor);
     m_ui->transformBenchmarkButton->setEnabled(false);
@@ -321,7 +339,7 @@ void DatabaseSettingsWidgetEncryption::benchmarkTransformRounds(int millisecs)
     }
 
     // Determine the number of rounds required to meet 1 second delay
-    int rounds = AsyncTask::runAndWaitForFuture([&kdf, millisecs]() { return kdf->benchmark(millisecs); });
+    int rounds = benchmarkKdf(kdf, millisecs, recalibrate);
 
     m_ui->transformRoundsSpinBox->setValue(rounds);
     m_ui->transformBenchmarkButton->setEnabled(true);
@@ -329,6 +347,14 @@ void DatabaseSettingsWidgetEncryption::benchmarkTransformRounds(int millisecs)
     QApplication::restoreOverrideCursor();
 }
 
+/**
+ * Benchmark the KDF on an explicit request, ignoring cached calibrations.
+ */
+void DatabaseSettingsWidgetEncryption::recalibrateTransformRounds()
+{
+    benchmarkTransformRounds(1000, true);
+}
+
 void DatabaseSettingsWidgetEncryption::changeKdf(int index)
 {
     Q_ASSERT(m_db);
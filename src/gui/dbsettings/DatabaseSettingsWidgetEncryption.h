@@ -50,7 +50,8 @@ protected:
     void showEvent(QShowEvent* event) override;
 
 private slots:
-    void benchmarkTransformRounds(int millisecs = 1000);
+    void benchmarkTransformRounds(int millisecs = 1000, bool recalibrate = false);
+    void recalibrateTransformRounds();
     void changeKdf(int index);
     void memoryChanged(int value);
     void parallelismChanged(int value);
@@ -23,22 +23,67 @@
 #include <QMimeData>
 #include <QPainter>
 #include <QPalette>
+#include <QTimer>
 
+#include <climits>
+
+#include "core/Clock.h"
 #include "core/Config.h"
+#include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Entry.h"
 #include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "totp/totp.h"
+
+namespace
+{
+    /**
+     * Milliseconds until the codes of the given TOTP step roll over,
+     * clamped to what a timer accepts
+     */
+    int msecsUntilNextStep(uint step)
+    {
+        const qint64 stepMsecs = static_cast<qint64>(qMax(step, 1u)) * 1000;
+        const qint64 now = Clock::currentDateTimeUtc().toMSecsSinceEpoch();
+        return static_cast<int>(qMin<qint64>(stepMsecs - now % stepMsecs, INT_MAX));
+    }
+
+    /**
+     * Attribute shown in one of the columns with cached display strings
+     */
+    QString displayedAttributeKey(int column)
+    {
+        switch (column) {
+        case EntryModel::Title:
+            return EntryAttributes::TitleKey;
+        case EntryModel::Username:
+            return EntryAttributes::UserNameKey;
+        case EntryModel::Password:
+            return EntryAttributes::PasswordKey;
+        default:
+            return EntryAttributes::URLKey;
+        }
+    }
+} // namespace
 
 EntryModel::EntryModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_group(nullptr)
+    , m_bulkUpdating(false)
+    , m_totpTimer(new QTimer(this))
     , m_hideUsernames(false)
     , m_hidePasswords(true)
     , HiddenContentDisplay(QString("\u25cf").repeated(6))
     , DateFormat(Qt::DefaultLocaleShortDate)
 {
+    setDisplayCacheRows(256);
+
+    // one timer refreshes the codes of all displayed entries, precisely at the step boundaries
+    m_totpTimer->setSingleShot(true);
+    m_totpTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_totpTimer, SIGNAL(timeout()), SLOT(refreshTotpCodes()));
 }
 
 Entry* EntryModel::entryFromIndex(const QModelIndex& index) const
@@ -60,6 +105,9 @@ void EntryModel::setGroup(Group* group)
         return;
     }
 
+    // the views may switch groups when a bulk update finishes, end our reset first
+    bulkUpdateFinished();
+
     beginResetModel();
 
     severConnections();
@@ -68,8 +116,12 @@ void EntryModel::setGroup(Group* group)
     m_allGroups.clear();
     m_entries = group->entries();
     m_orgEntries.clear();
+    clearDisplayCache();
+    m_referencingEntries.clear();
+    clearTotpCodes();
 
     makeConnections(group);
+    connectDatabase(group->database());
 
     endResetModel();
     emit switchedToListMode();
@@ -77,6 +129,8 @@ void EntryModel::setGroup(Group* group)
 
 void EntryModel::setEntryList(const QList<Entry*>& entries)
 {
+    bulkUpdateFinished();
+
     beginResetModel();
 
     severConnections();
@@ -84,16 +138,22 @@ void EntryModel::setEntryList(const QList<Entry*>& entries)
     m_group = nullptr;
     m_allGroups.clear();
     m_entries = entries;
-    m_orgEntries = entries;
+    m_orgEntries.clear();
+    m_orgEntries.reserve(entries.size());
+    clearDisplayCache();
+    m_referencingEntries.clear();
+    clearTotpCodes();
 
     QSet<Database*> databases;
 
     for (Entry* entry : asConst(m_entries)) {
+        m_orgEntries.insert(entry);
         databases.insert(entry->group()->database());
     }
 
     for (Database* db : asConst(databases)) {
         Q_ASSERT(db);
+        connectDatabase(db);
         const QList<Group*> groupList = db->rootGroup()->groupsRecursive(true);
         for (const Group* group : groupList) {
             m_allGroups.append(group);
@@ -149,40 +209,21 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             }
             break;
         case Title:
-            result = entry->resolveMultiplePlaceholders(entry->title());
-            if (attr->isReference(EntryAttributes::TitleKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
-            }
-            return result;
         case Username:
-            if (m_hideUsernames) {
-                result = EntryModel::HiddenContentDisplay;
-            } else {
-                result = entry->resolveMultiplePlaceholders(entry->username());
-            }
-            if (attr->isReference(EntryAttributes::UserNameKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
-            }
-            return result;
         case Password:
-            if (m_hidePasswords) {
-                result = EntryModel::HiddenContentDisplay;
-            } else {
-                result = entry->resolveMultiplePlaceholders(entry->password());
+        case Url: {
+            // resolving placeholders is expensive, keep the strings of the visible rows
+            const QPair<const Entry*, int> key(entry, index.column());
+            if (const QString* cached = m_displayCache.object(key)) {
+                return *cached;
             }
-            if (attr->isReference(EntryAttributes::PasswordKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
-            }
-            if (entry->password().isEmpty() && config()->get("security/passwordemptynodots").toBool()) {
-                result = "";
-            }
-            return result;
-        case Url:
-            result = entry->resolveMultiplePlaceholders(entry->displayUrl());
-            if (attr->isReference(EntryAttributes::URLKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
+            result = resolvedDisplayString(entry, index.column());
+            m_displayCache.insert(key, new QString(result));
+            if (attr->isReference(displayedAttributeKey(index.column()))) {
+                m_referencingEntries.insert(entry);
             }
             return result;
+        }
         case Notes:
             // Display only first line of notes in simplified format
             result = entry->notes().section("\n", 0, 0).simplified();
@@ -218,7 +259,9 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             return result;
         }
         case Totp:
-            result = entry->hasTotp() ? tr("Yes") : "";
+            if (entry->hasTotp()) {
+                return totpCode(entry);
+            }
             return result;
         }
     } else if (role == Qt::UserRole) { // Qt::UserRole is used as sort role, see EntryView::EntryView()
@@ -240,6 +283,9 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             // Display entries with attachments above those without when
             // sorting ascendingly (and vice versa when sorting descendingly)
             return entry->attachments()->isEmpty() ? 1 : 0;
+        case Totp:
+            // Sort by presence, the codes change with every step
+            return entry->hasTotp() ? 0 : 1;
         default:
             // For all other columns, simply use data provided by Qt::Display-
             // Role for sorting
@@ -289,6 +335,155 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
     return QVariant();
 }
 
+QString EntryModel::resolvedDisplayString(const Entry* entry, int column) const
+{
+    const EntryAttributes* attr = entry->attributes();
+    QString result;
+    switch (column) {
+    case Title:
+        result = entry->resolveMultiplePlaceholders(entry->title());
+        if (attr->isReference(EntryAttributes::TitleKey)) {
+            result.prepend(tr("Ref: ", "Reference abbreviation"));
+        }
+        break;
+    case Username:
+        if (m_hideUsernames) {
+            result = EntryModel::HiddenContentDisplay;
+        } else {
+            result = entry->resolveMultiplePlaceholders(entry->username());
+        }
+        if (attr->isReference(EntryAttributes::UserNameKey)) {
+            result.prepend(tr("Ref: ", "Reference abbreviation"));
+        }
+        break;
+    case Password:
+        if (m_hidePasswords) {
+            result = EntryModel::HiddenContentDisplay;
+        } else {
+            result = entry->resolveMultiplePlaceholders(entry->password());
+        }
+        if (attr->isReference(EntryAttributes::PasswordKey)) {
+            result.prepend(tr("Ref: ", "Reference abbreviation"));
+        }
+        if (entry->password().isEmpty() && config()->get("security/passwordemptynodots").toBool()) {
+            result = "";
+        }
+        break;
+    case Url:
+        result = entry->resolveMultiplePlaceholders(entry->displayUrl());
+        if (attr->isReference(EntryAttributes::URLKey)) {
+            result.prepend(tr("Ref: ", "Reference abbreviation"));
+        }
+        break;
+    }
+    return result;
+}
+
+/**
+ * Limit the cache of resolved display strings to the given number of rows.
+ * The view sets this to the rows in its viewport plus a prefetch margin,
+ * so scrolling through long search results resolves every row only once.
+ */
+void EntryModel::setDisplayCacheRows(int rows)
+{
+    // Title, Username, Password and Url are cached per row
+    m_displayCache.setMaxCost(qMax(1, rows) * 4);
+}
+
+void EntryModel::clearDisplayCache()
+{
+    m_displayCache.clear();
+}
+
+/**
+ * Current TOTP code of an entry. Codes are generated once per step: the
+ * shared timer regenerates the codes of all displayed entries in one batch
+ * when they roll over, see refreshTotpCodes().
+ */
+QString EntryModel::totpCode(const Entry* entry) const
+{
+    m_totpShown.insert(entry);
+
+    auto it = m_totpCodes.constFind(entry);
+    if (it != m_totpCodes.constEnd()) {
+        return it.value();
+    }
+
+    QSharedPointer<Totp::Context> context = entry->totpContext();
+    if (!context) {
+        return {};
+    }
+
+    const QString code = Totp::generateTotp(*context);
+    m_totpCodes.insert(entry, code);
+
+    const int msecs = msecsUntilNextStep(context->step);
+    if (!m_totpTimer->isActive() || msecs < m_totpTimer->remainingTime()) {
+        m_totpTimer->start(msecs);
+    }
+    return code;
+}
+
+void EntryModel::clearTotpCodes()
+{
+    m_totpCodes.clear();
+    m_totpShown.clear();
+    m_totpTimer->stop();
+}
+
+/**
+ * Regenerate the TOTP codes of the entries displayed since the last refresh
+ * and notify the views with a single range. Repainting that range marks the
+ * entries that are still visible; once nothing is displayed anymore, e.g.
+ * because the column was hidden, the timer is no longer restarted.
+ */
+void EntryModel::refreshTotpCodes()
+{
+    QList<const Entry*> entries;
+    QList<QSharedPointer<Totp::Context>> contexts;
+    int firstRow = -1;
+    int lastRow = -1;
+    int msecs = -1;
+
+    for (int row = 0; row < m_entries.size(); ++row) {
+        const Entry* entry = m_entries.at(row);
+        if (!m_totpShown.contains(entry) || !entry->hasTotp()) {
+            continue;
+        }
+        QSharedPointer<Totp::Context> context = entry->totpContext();
+        if (!context) {
+            continue;
+        }
+
+        entries.append(entry);
+        contexts.append(context);
+        if (firstRow < 0) {
+            firstRow = row;
+        }
+        lastRow = row;
+        const int next = msecsUntilNextStep(context->step);
+        if (msecs < 0 || next < msecs) {
+            msecs = next;
+        }
+    }
+
+    m_totpCodes.clear();
+    m_totpShown.clear();
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    const QStringList codes = Totp::generateTotps(contexts);
+    for (int i = 0; i < entries.size(); ++i) {
+        m_totpCodes.insert(entries.at(i), codes.at(i));
+    }
+    m_totpTimer->start(msecs);
+
+    if (!m_bulkUpdating) {
+        emit dataChanged(index(firstRow, Totp), index(lastRow, Totp));
+    }
+}
+
 QVariant EntryModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     Q_UNUSED(orientation);
@@ -396,6 +591,13 @@ void EntryModel::entryAboutToAdd(Entry* entry)
         return;
     }
 
+    if (m_bulkUpdating) {
+        if (!m_group) {
+            m_entries.append(entry);
+        }
+        return;
+    }
+
     beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
     if (!m_group) {
         m_entries.append(entry);
@@ -404,7 +606,7 @@ void EntryModel::entryAboutToAdd(Entry* entry)
 
 void EntryModel::entryAdded(Entry* entry)
 {
-    if (!m_group && !m_orgEntries.contains(entry)) {
+    if (m_bulkUpdating || (!m_group && !m_orgEntries.contains(entry))) {
         return;
     }
 
@@ -416,6 +618,17 @@ void EntryModel::entryAdded(Entry* entry)
 
 void EntryModel::entryAboutToRemove(Entry* entry)
 {
+    // the address may be reused by a new entry
+    clearDisplayCache();
+    m_totpCodes.remove(entry);
+    m_totpShown.remove(entry);
+
+    if (m_bulkUpdating) {
+        // also drops the entries of a group that is deleted during the update
+        m_entries.removeAll(entry);
+        return;
+    }
+
     beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
     if (!m_group) {
         m_entries.removeAll(entry);
@@ -424,6 +637,10 @@ void EntryModel::entryAboutToRemove(Entry* entry)
 
 void EntryModel::entryRemoved()
 {
+    if (m_bulkUpdating) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -433,19 +650,80 @@ void EntryModel::entryRemoved()
 
 void EntryModel::entryDataChanged(Entry* entry)
 {
+    // other entries may show the changed data through references
+    clearDisplayCache();
+    m_totpCodes.remove(entry);
+
+    if (m_bulkUpdating) {
+        return;
+    }
+
     int row = m_entries.indexOf(entry);
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
+/**
+ * References are resolved from entries in any group of the database, which
+ * includes groups this model is not connected to. Refresh the rows showing
+ * references whenever anything in one of the databases changes.
+ */
+void EntryModel::databaseModified()
+{
+    if (m_referencingEntries.isEmpty() || m_bulkUpdating) {
+        return;
+    }
+
+    clearDisplayCache();
+    for (const Entry* entry : asConst(m_referencingEntries)) {
+        int row = m_entries.indexOf(const_cast<Entry*>(entry));
+        if (row >= 0) {
+            emit dataChanged(index(row, Title), index(row, Url));
+        }
+    }
+}
+
+void EntryModel::bulkUpdateStarted()
+{
+    if (m_bulkUpdating) {
+        return;
+    }
+
+    m_bulkUpdating = true;
+    beginResetModel();
+}
+
+void EntryModel::bulkUpdateFinished()
+{
+    if (!m_bulkUpdating) {
+        return;
+    }
+
+    m_bulkUpdating = false;
+    if (m_group) {
+        m_entries = m_group->entries();
+    }
+    clearDisplayCache();
+    m_referencingEntries.clear();
+    clearTotpCodes();
+    endResetModel();
+}
+
 void EntryModel::severConnections()
 {
     if (m_group) {
-        disconnect(m_group, nullptr, this, nullptr);
+        disconnect(m_group.data(), nullptr, this, nullptr);
     }
 
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const QPointer<Database>& db : asConst(m_databases)) {
+        if (db) {
+            disconnect(db.data(), nullptr, this, nullptr);
+        }
+    }
+    m_databases.clear();
 }
 
 void EntryModel::makeConnections(const Group* group)
@@ -457,6 +735,18 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
 }
 
+void EntryModel::connectDatabase(Database* db)
+{
+    if (!db) {
+        return;
+    }
+
+    connect(db, SIGNAL(bulkUpdateStarted()), SLOT(bulkUpdateStarted()));
+    connect(db, SIGNAL(bulkUpdateFinished()), SLOT(bulkUpdateFinished()));
+    connect(db, SIGNAL(modifiedImmediate()), SLOT(databaseModified()));
+    m_databases.append(db);
+}
+
 /**
  * Get current state of 'Hide Usernames' setting
  */
@@ -471,6 +761,7 @@ bool EntryModel::isUsernamesHidden() const
 void EntryModel::setUsernamesHidden(const bool hide)
 {
     m_hideUsernames = hide;
+    clearDisplayCache();
     emit usernamesHiddenChanged();
 }
 
@@ -488,6 +779,7 @@ bool EntryModel::isPasswordsHidden() const
 void EntryModel::setPasswordsHidden(const bool hide)
 {
     m_hidePasswords = hide;
+    clearDisplayCache();
     emit passwordsHiddenChanged();
 }
 
@@ -19,10 +19,16 @@
 #define KEEPASSX_ENTRYMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCache>
+#include <QHash>
 #include <QPixmap>
+#include <QPointer>
+#include <QSet>
 
+class Database;
 class Entry;
 class Group;
+class QTimer;
 
 class EntryModel : public QAbstractTableModel
 {
@@ -68,6 +74,7 @@ public:
     void setPasswordsHidden(const bool hide);
 
     void setPaperClipPixmap(const QPixmap& paperclip);
+    void setDisplayCacheRows(int rows);
 
 signals:
     void switchedToListMode();
@@ -86,15 +93,34 @@ private slots:
     void entryAboutToRemove(Entry* entry);
     void entryRemoved();
     void entryDataChanged(Entry* entry);
+    void databaseModified();
+    void bulkUpdateStarted();
+    void bulkUpdateFinished();
+    void refreshTotpCodes();
 
 private:
     void severConnections();
     void makeConnections(const Group* group);
+    void connectDatabase(Database* db);
+    QString resolvedDisplayString(const Entry* entry, int column) const;
+    void clearDisplayCache();
+    QString totpCode(const Entry* entry) const;
+    void clearTotpCodes();
 
-    Group* m_group;
+    QPointer<Group> m_group;
     QList<Entry*> m_entries;
-    QList<Entry*> m_orgEntries;
+    QSet<const Entry*> m_orgEntries;
     QList<const Group*> m_allGroups;
+    QList<QPointer<Database>> m_databases;
+    bool m_bulkUpdating;
+    // resolved display strings of the rows around the viewport
+    mutable QCache<QPair<const Entry*, int>, QString> m_displayCache;
+    // entries whose cached display strings were resolved through references
+    mutable QSet<const Entry*> m_referencingEntries;
+    // current TOTP codes, and the entries whose code was displayed since the last refresh
+    mutable QHash<const Entry*, QString> m_totpCodes;
+    mutable QSet<const Entry*> m_totpShown;
+    QTimer* const m_totpTimer;
 
     bool m_hideUsernames;
     bool m_hidePasswords;
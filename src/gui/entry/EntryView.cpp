@@ -146,6 +146,20 @@ void EntryView::keyPressEvent(QKeyEvent* event)
     QTreeView::keyPressEvent(event);
 }
 
+void EntryView::resizeEvent(QResizeEvent* event)
+{
+    // required for fitting the columns to the window, see fitColumnsToWindow()
+    QTreeView::resizeEvent(event);
+
+    // cache the visible rows and one page above and below them
+    int rowHeight = sizeHintForRow(0);
+    if (rowHeight <= 0) {
+        rowHeight = fontMetrics().height();
+    }
+    const int visibleRows = viewport()->height() / qMax(1, rowHeight) + 1;
+    m_model->setDisplayCacheRows(visibleRows * 3);
+}
+
 void EntryView::setGroup(Group* group)
 {
     m_model->setGroup(group);
@@ -50,6 +50,8 @@ void GroupModel::changeDatabase(Database* newDb)
     connect(m_db, SIGNAL(groupRemoved()), SLOT(groupRemoved()));
     connect(m_db, SIGNAL(groupAboutToMove(Group*,Group*,int)), SLOT(groupAboutToMove(Group*,Group*,int)));
     connect(m_db, SIGNAL(groupMoved()), SLOT(groupMoved()));
+    connect(m_db, SIGNAL(bulkUpdateStarted()), SLOT(bulkUpdateStarted()));
+    connect(m_db, SIGNAL(bulkUpdateFinished()), SLOT(bulkUpdateFinished()));
 
     endResetModel();
 }
@@ -83,7 +85,8 @@ QModelIndex GroupModel::index(int row, int column, const QModelIndex& parent) co
     if (!parent.isValid()) {
         group = m_db->rootGroup();
     } else {
-        group = groupFromIndex(parent)->children().at(row);
+        const Group* parentGroup = groupFromIndex(parent);
+        group = parentGroup->children().at(row);
     }
 
     return createIndex(row, column, group);
@@ -111,7 +114,7 @@ QModelIndex GroupModel::parent(Group* group) const
             // parent is the root group
             return createIndex(0, 0, parentGroup);
         } else {
-            return createIndex(grandParentGroup->children().indexOf(parentGroup), 0, parentGroup);
+            return createIndex(parentGroup->indexInParent(), 0, parentGroup);
         }
     }
 }
@@ -159,7 +162,7 @@ QModelIndex GroupModel::index(Group* group) const
     if (!group->parentGroup()) {
         row = 0;
     } else {
-        row = group->parentGroup()->children().indexOf(group);
+        row = group->indexInParent();
     }
 
     return createIndex(row, 0, group);
@@ -242,7 +245,7 @@ bool GroupModel::dropMimeData(const QMimeData* data,
             return false;
         }
 
-        if (parentGroup == dragGroup->parent() && row > parentGroup->children().indexOf(dragGroup)) {
+        if (parentGroup == dragGroup->parent() && row > dragGroup->indexInParent()) {
             row--;
         }
 
@@ -267,6 +270,9 @@ bool GroupModel::dropMimeData(const QMimeData* data,
             return false;
         }
 
+        Database* targetDb = parentGroup->database();
+        int droppedEntries = 0;
+
         while (!stream.atEnd()) {
             QUuid dbUuid;
             QUuid entryUuid;
@@ -290,15 +296,22 @@ bool GroupModel::dropMimeData(const QMimeData* data,
             }
 
             Database* sourceDb = dragEntry->group()->database();
-            Database* targetDb = parentGroup->database();
             QUuid customIcon = entry->iconUuid();
 
             if (sourceDb != targetDb && !customIcon.isNull() && !targetDb->metadata()->containsCustomIcon(customIcon)) {
                 targetDb->metadata()->addCustomIcon(customIcon, sourceDb->metadata()->customIcon(customIcon));
             }
 
+            // a single entry is moved in place, the views are reset once for many
+            if (++droppedEntries == 2) {
+                targetDb->beginBulkUpdate();
+            }
             entry->setGroup(parentGroup);
         }
+
+        if (droppedEntries >= 2) {
+            targetDb->endBulkUpdate();
+        }
     }
 
     return true;
@@ -349,17 +362,25 @@ QMimeData* GroupModel::mimeData(const QModelIndexList& indexes) const
 
 void GroupModel::groupDataChanged(Group* group)
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     QModelIndex ix = index(group);
     emit dataChanged(ix, ix);
 }
 
 void GroupModel::groupAboutToRemove(Group* group)
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex parentIndex = parent(group);
     Q_ASSERT(parentIndex.isValid());
-    int pos = group->parentGroup()->children().indexOf(group);
+    int pos = group->indexInParent();
     Q_ASSERT(pos != -1);
 
     beginRemoveRows(parentIndex, pos, pos);
@@ -367,11 +388,19 @@ void GroupModel::groupAboutToRemove(Group* group)
 
 void GroupModel::groupRemoved()
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     endRemoveRows();
 }
 
 void GroupModel::groupAboutToAdd(Group* group, int index)
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex parentIndex = parent(group);
@@ -381,16 +410,24 @@ void GroupModel::groupAboutToAdd(Group* group, int index)
 
 void GroupModel::groupAdded()
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     endInsertRows();
 }
 
 void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex oldParentIndex = parent(group);
     QModelIndex newParentIndex = index(toGroup);
-    int oldPos = group->parentGroup()->children().indexOf(group);
+    int oldPos = group->indexInParent();
     if (group->parentGroup() == toGroup && pos > oldPos) {
         // beginMoveRows() has a bit different semantics than Group::setParent() and
         // QList::move() when the new position is greater than the old
@@ -404,5 +441,19 @@ void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 
 void GroupModel::groupMoved()
 {
+    if (m_db->isBulkUpdating()) {
+        return;
+    }
+
     endMoveRows();
 }
+
+void GroupModel::bulkUpdateStarted()
+{
+    beginResetModel();
+}
+
+void GroupModel::bulkUpdateFinished()
+{
+    endResetModel();
+}
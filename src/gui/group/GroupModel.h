@@ -57,6 +57,8 @@ private slots:
     void groupAdded();
     void groupAboutToMove(Group* group, Group* toGroup, int pos);
     void groupMoved();
+    void bulkUpdateStarted();
+    void bulkUpdateFinished();
 
 private:
     Database* m_db;
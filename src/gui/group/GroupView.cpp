@@ -37,6 +37,7 @@ GroupView::GroupView(Database* db, QWidget* parent)
     connect(this, SIGNAL(expanded(QModelIndex)), this, SLOT(expandedChanged(QModelIndex)));
     connect(this, SIGNAL(collapsed(QModelIndex)), this, SLOT(expandedChanged(QModelIndex)));
     connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(syncExpandedState(QModelIndex,int,int)));
+    connect(m_model, SIGNAL(modelAboutToBeReset()), SLOT(modelAboutToBeReset()));
     connect(m_model, SIGNAL(modelReset()), SLOT(modelReset()));
 
     connect(selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), SLOT(emitGroupChanged()));
@@ -147,8 +148,22 @@ void GroupView::setCurrentGroup(Group* group)
         setCurrentIndex(m_model->index(group));
 }
 
+void GroupView::modelAboutToBeReset()
+{
+    m_resetCurrentGroup = currentGroup();
+}
+
 void GroupView::modelReset()
 {
-    recInitExpanded(m_model->groupFromIndex(m_model->index(0, 0)));
-    setCurrentIndex(m_model->index(0, 0));
+    Group* rootGroup = m_model->groupFromIndex(m_model->index(0, 0));
+    recInitExpanded(rootGroup);
+
+    // keep the selection if the group survived e.g. a bulk update of the same database
+    Group* group = m_resetCurrentGroup;
+    m_resetCurrentGroup.clear();
+    if (group && group->database() && group->database()->rootGroup() == rootGroup) {
+        setCurrentGroup(group);
+    } else {
+        setCurrentIndex(m_model->index(0, 0));
+    }
 }
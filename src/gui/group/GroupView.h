@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_GROUPVIEW_H
 #define KEEPASSX_GROUPVIEW_H
 
+#include <QPointer>
 #include <QTreeView>
 
 class Database;
@@ -46,6 +47,7 @@ private slots:
     void emitGroupChanged();
     void emitGroupPressed(const QModelIndex& index);
     void syncExpandedState(const QModelIndex& parent, int start, int end);
+    void modelAboutToBeReset();
     void modelReset();
 
 protected:
@@ -56,6 +58,7 @@ private:
 
     GroupModel* const m_model;
     bool m_updatingExpanded;
+    QPointer<Group> m_resetCurrentGroup;
 };
 
 #endif // KEEPASSX_GROUPVIEW_H
@@ -41,6 +41,9 @@ void CompositeKey::clear()
 {
     m_keys.clear();
     m_challengeResponseKeys.clear();
+    m_transformedKeyKdf = QUuid();
+    m_transformedKeyParameters.clear();
+    m_transformedKey.clear();
 }
 
 bool CompositeKey::isEmpty() const
@@ -112,6 +115,12 @@ QByteArray CompositeKey::rawKey(const QByteArray* transformSeed, bool* ok) const
  */
 bool CompositeKey::transform(const Kdf& kdf, QByteArray& result) const
 {
+    if (!m_transformedKey.isEmpty() && kdf.uuid() == m_transformedKeyKdf
+        && kdf.writeParameters() == m_transformedKeyParameters) {
+        result = m_transformedKey;
+        return true;
+    }
+
     if (kdf.uuid() == KeePass2::KDF_AES_KDBX3) {
         // legacy KDBX3 AES-KDF, challenge response is added later to the hash
         return kdf.transform(rawKey(), result);
@@ -123,6 +132,22 @@ bool CompositeKey::transform(const Kdf& kdf, QByteArray& result) const
     return kdf.transform(rawKey(&seed, &ok), result) && ok;
 }
 
+/**
+ * Provide the result of a key transformation that was computed ahead of time,
+ * e.g. in the background while the user was still entering the key.
+ * transform() will return it instead of running the KDF again as long as it is
+ * called with a KDF with identical parameters. Adding key components discards it.
+ *
+ * @param kdf key derivation function the key was transformed with
+ * @param transformedKey result of transform() for this composite key and kdf
+ */
+void CompositeKey::setTransformedKey(const Kdf& kdf, const QByteArray& transformedKey)
+{
+    m_transformedKeyKdf = kdf.uuid();
+    m_transformedKeyParameters = kdf.writeParameters();
+    m_transformedKey = transformedKey;
+}
+
 bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result) const
 {
     // if no challenge response was requested, return nothing to
@@ -156,6 +181,7 @@ bool CompositeKey::challenge(const QByteArray& seed, QByteArray& result) const
 void CompositeKey::addKey(const QSharedPointer<Key>& key)
 {
     m_keys.append(key);
+    m_transformedKey.clear();
 }
 
 /**
@@ -176,6 +202,7 @@ const QList<QSharedPointer<Key>>& CompositeKey::keys() const
 void CompositeKey::addChallengeResponseKey(const QSharedPointer<ChallengeResponseKey>& key)
 {
     m_challengeResponseKeys.append(key);
+    m_transformedKey.clear();
 }
 
 /**
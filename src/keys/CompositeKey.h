@@ -40,6 +40,7 @@ public:
     QByteArray rawKey() const override;
     QByteArray rawKey(const QByteArray* transformSeed, bool* ok = nullptr) const;
     Q_REQUIRED_RESULT bool transform(const Kdf& kdf, QByteArray& result) const;
+    void setTransformedKey(const Kdf& kdf, const QByteArray& transformedKey);
     bool challenge(const QByteArray& seed, QByteArray& result) const;
 
     void addKey(const QSharedPointer<Key>& key);
@@ -51,6 +52,9 @@ public:
 private:
     QList<QSharedPointer<Key>> m_keys;
     QList<QSharedPointer<ChallengeResponseKey>> m_challengeResponseKeys;
+    QUuid m_transformedKeyKdf;
+    QVariantMap m_transformedKeyParameters;
+    QByteArray m_transformedKey;
 };
 
 #endif // KEEPASSX_COMPOSITEKEY_H
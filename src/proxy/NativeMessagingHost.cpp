@@ -53,56 +53,18 @@ NativeMessagingHost::~NativeMessagingHost()
 #endif
 }
 
-void NativeMessagingHost::readNativeMessages()
+void NativeMessagingHost::handleNativeMessage(const QByteArray& message)
 {
-#ifdef Q_OS_WIN
-    quint32 length = 0;
-    while (m_running.load() && !std::cin.eof()) {
-        length = 0;
-        std::cin.read(reinterpret_cast<char*>(&length), 4);
-        if (!readStdIn(length)) {
-            QCoreApplication::quit();
-        }
-        QThread::msleep(1);
-    }
-#endif
-}
-
-void NativeMessagingHost::readLength()
-{
-    quint32 length = 0;
-    std::cin.read(reinterpret_cast<char*>(&length), 4);
-    if (!std::cin.eof() && length > 0) {
-        readStdIn(length);
-    } else {
-        QCoreApplication::quit();
+    // relay the message straight from the read buffer
+    if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
+        m_localSocket->write(message.constData(), message.length());
+        m_localSocket->flush();
     }
 }
 
-bool NativeMessagingHost::readStdIn(const quint32 length)
+void NativeMessagingHost::nativeInputClosed()
 {
-    if (length <= 0) {
-        return false;
-    }
-
-    QByteArray arr;
-    arr.reserve(length);
-
-    for (quint32 i = 0; i < length; ++i) {
-        int c = std::getchar();
-        if (c == EOF) {
-            // message ended prematurely, ignore it and return
-            return false;
-        }
-        arr.append(static_cast<char>(c));
-    }
-
-    if (arr.length() > 0 && m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(arr.constData(), arr.length());
-        m_localSocket->flush();
-    }
-    
-    return true;
+    QCoreApplication::quit();
 }
 
 void NativeMessagingHost::newLocalMessage()
@@ -111,7 +73,8 @@ void NativeMessagingHost::newLocalMessage()
         return;
     }
 
-    QByteArray arr = m_localSocket->readAll();
+    // relay the reply without converting it to a string
+    const QByteArray arr = m_localSocket->readAll();
     if (!arr.isEmpty()) {
         sendReply(arr);
     }
@@ -33,9 +33,8 @@ public slots:
     void socketStateChanged(QLocalSocket::LocalSocketState socketState);
 
 private:
-    void readNativeMessages();
-    void readLength();
-    bool readStdIn(const quint32 length);
+    void handleNativeMessage(const QByteArray& message) override;
+    void nativeInputClosed() override;
 
 private:
     QLocalSocket* m_localSocket;
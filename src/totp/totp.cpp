@@ -21,7 +21,6 @@
 #include "core/Clock.h"
 
 #include <QCryptographicHash>
-#include <QMessageAuthenticationCode>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QUrl>
@@ -30,6 +29,8 @@
 #include <QtEndian>
 #include <cmath>
 
+static const int HmacBlockSize = 64;
+
 static QList<Totp::Encoder> encoders {
     {"", "", "0123456789", Totp::DEFAULT_DIGITS, Totp::DEFAULT_STEP, false},
     {"steam", Totp::STEAM_SHORTNAME, "23456789BCDFGHJKMNPQRTVWXY", Totp::STEAM_DIGITS, Totp::DEFAULT_STEP, true},
@@ -134,9 +135,53 @@ QString Totp::generateTotp(const QSharedPointer<Totp::Settings>& settings, const
         return QObject::tr("Invalid Settings", "TOTP");
     }
 
-    const Encoder& encoder = settings->encoder;
-    uint step = settings->custom ? settings->step : encoder.step;
-    uint digits = settings->custom ? settings->digits : encoder.digits;
+    return generateTotp(*createContext(settings), time);
+}
+
+/**
+ * Decode the key of the settings and prepare the HMAC pads once, for
+ * generating many codes with the same settings.
+ */
+QSharedPointer<Totp::Context> Totp::createContext(const QSharedPointer<Totp::Settings>& settings)
+{
+    Q_ASSERT(!settings.isNull());
+
+    QSharedPointer<Totp::Context> context(new Totp::Context());
+    context->settings = settings;
+    context->encoder = settings->encoder;
+    context->step = settings->custom ? settings->step : settings->encoder.step;
+    context->digits = settings->custom ? settings->digits : settings->encoder.digits;
+
+    QVariant secret = Base32::decode(Base32::sanitizeInput(settings->key.toLatin1()));
+    context->validKey = !secret.isNull();
+    if (!context->validKey) {
+        return context;
+    }
+
+    QByteArray key = secret.toByteArray();
+    if (key.size() > HmacBlockSize) {
+        key = QCryptographicHash::hash(key, QCryptographicHash::Sha1);
+    }
+    key.append(QByteArray(HmacBlockSize - key.size(), '\0'));
+
+    context->innerPad.resize(HmacBlockSize);
+    context->outerPad.resize(HmacBlockSize);
+    for (int i = 0; i < HmacBlockSize; ++i) {
+        context->innerPad[i] = static_cast<char>(key.at(i) ^ 0x36);
+        context->outerPad[i] = static_cast<char>(key.at(i) ^ 0x5c);
+    }
+    return context;
+}
+
+QString Totp::generateTotp(const Totp::Context& context, const quint64 time)
+{
+    if (!context.validKey) {
+        return QObject::tr("Invalid Key", "TOTP");
+    }
+
+    const Encoder& encoder = context.encoder;
+    const uint step = context.step;
+    const uint digits = context.digits;
 
     quint64 current;
     if (time == 0) {
@@ -145,15 +190,14 @@ QString Totp::generateTotp(const QSharedPointer<Totp::Settings>& settings, const
         current = qToBigEndian(time / step);
     }
 
-    QVariant secret = Base32::decode(Base32::sanitizeInput(settings->key.toLatin1()));
-    if (secret.isNull()) {
-        return QObject::tr("Invalid Key", "TOTP");
-    }
-
-    QMessageAuthenticationCode code(QCryptographicHash::Sha1);
-    code.setKey(secret.toByteArray());
-    code.addData(QByteArray(reinterpret_cast<char*>(&current), sizeof(current)));
-    QByteArray hmac = code.result();
+    // HMAC-SHA1 of the counter with the precomputed pads
+    QCryptographicHash inner(QCryptographicHash::Sha1);
+    inner.addData(context.innerPad);
+    inner.addData(reinterpret_cast<const char*>(&current), sizeof(current));
+    QCryptographicHash outer(QCryptographicHash::Sha1);
+    outer.addData(context.outerPad);
+    outer.addData(inner.result());
+    QByteArray hmac = outer.result();
 
     int offset = (hmac[hmac.length() - 1] & 0xf);
 
@@ -182,6 +226,22 @@ QString Totp::generateTotp(const QSharedPointer<Totp::Settings>& settings, const
     return retval;
 }
 
+/**
+ * Generate the codes of many contexts for the same point in time, e.g. for
+ * all visible entries of a view. Null contexts get an empty code.
+ */
+QStringList Totp::generateTotps(const QList<QSharedPointer<Totp::Context>>& contexts, const quint64 time)
+{
+    const quint64 now = time == 0 ? static_cast<quint64>(Clock::currentSecondsSinceEpoch()) : time;
+
+    QStringList codes;
+    codes.reserve(contexts.size());
+    for (const QSharedPointer<Totp::Context>& context : contexts) {
+        codes.append(context ? generateTotp(*context, now) : QString());
+    }
+    return codes;
+}
+
 Totp::Encoder& Totp::defaultEncoder()
 {
     // The first encoder is always the default
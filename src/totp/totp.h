@@ -19,8 +19,11 @@
 #ifndef QTOTP_H
 #define QTOTP_H
 
+#include <QByteArray>
+#include <QList>
 #include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QtCore/qglobal.h>
 #include <QtCore/QSharedPointer>
 
@@ -48,6 +51,22 @@ struct Settings
     uint step;
 };
 
+/**
+ * Precomputed state for generating the codes of one TOTP secret: the decoded
+ * key XORed into the inner and outer HMAC-SHA1 pads, and the effective
+ * encoder, step and digits.
+ */
+struct Context
+{
+    QSharedPointer<Totp::Settings> settings;
+    Totp::Encoder encoder;
+    uint step;
+    uint digits;
+    bool validKey;
+    QByteArray innerPad;
+    QByteArray outerPad;
+};
+
 constexpr uint DEFAULT_STEP = 30u;
 constexpr uint DEFAULT_DIGITS = 6u;
 constexpr uint STEAM_DIGITS = 5u;
@@ -64,6 +83,9 @@ QString writeSettings(const QSharedPointer<Totp::Settings>& settings, const QStr
                       const QString& username = {}, bool forceOtp = false);
 
 QString generateTotp(const QSharedPointer<Totp::Settings>& settings, const quint64 time = 0ull);
+QSharedPointer<Totp::Context> createContext(const QSharedPointer<Totp::Settings>& settings);
+QString generateTotp(const Totp::Context& context, const quint64 time = 0ull);
+QStringList generateTotps(const QList<QSharedPointer<Totp::Context>>& contexts, const quint64 time = 0ull);
 
 Encoder& defaultEncoder();
 Encoder& steamEncoder();
@@ -171,8 +171,10 @@ static ZxcMatch_t *AllocMatch()
 /**********************************************************************************
  * Add new match struct to linked list of matches. List ordered with shortest at
  * head of list. Note: passed new match struct in parameter Nu may be de allocated.
+ * Returns the link to the list entry with the length of the new match, so several
+ * matches of increasing length can be added without searching the list from the head.
  */
-static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
+static ZxcMatch_t **InsertResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
 {
     /* Adjust the entropy to be used for calculations depending on whether the passed match is
      * at the begining, middle or end of the password
@@ -214,6 +216,15 @@ static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
         Nu->Next = *HeadRef;
         *HeadRef = Nu;
     }
+    return HeadRef;
+}
+
+/**********************************************************************************
+ * Add new match struct to linked list of matches, see InsertResult().
+ */
+static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
+{
+    InsertResult(HeadRef, Nu, MaxLen);
 }
 
 /**********************************************************************************
@@ -453,7 +464,10 @@ void ZxcvbnUnInit()
 
 #else
 
-/* Include the source file containing the dictionary data */
+/* Include the source file containing the dictionary data. Apart from the small */
+/* WordEndBits, its arrays are static const, so they live in the read-only image */
+/* of the executable: the pages are only read in when matching touches them and */
+/* are shared between processes running the same binary, without a file to map. */
 #include "dict-src.h"
 
 #endif
@@ -1644,8 +1658,11 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
     {
         int MaxLen = Len - i;
         int j;
+        ZxcMatch_t **Pos = &(Nodes[i].Paths);
         if (!RevPwd[i])
             continue;
+        /* Matches are added with increasing length, so continue searching the list */
+        /* from the previous one. Avoids cubic run time for long passphrases. */
         for(j = i+1; j <= Len; ++j)
         {
             if (RevPwd[j])
@@ -1655,7 +1672,7 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
                 Zp->Begin = i;
                 Zp->Length = j - i;
                 Zp->Entrpy = e * (j - i);
-                AddResult(&(Nodes[i].Paths), Zp, MaxLen);
+                Pos = InsertResult(Pos, Zp, MaxLen);
             }
         }
     }
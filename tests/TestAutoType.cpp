@@ -163,6 +163,40 @@ void TestAutoType::testGlobalAutoTypeWithOneMatch()
     QCOMPARE(m_test->actionChars(), QString("%1association%2").arg(m_entry1->username()).arg(m_entry1->password()));
 }
 
+void TestAutoType::testGlobalAutoTypeIndexUpdate()
+{
+    m_test->setActiveWindowTitle("Other Window - Browser");
+    MessageBox::setNextAnswer(QMessageBox::Ok);
+    m_autoType->performGlobalAutoType(m_dbList);
+    QCOMPARE(m_test->actionChars(), QString());
+
+    // a new association is found without reopening the database
+    AutoTypeAssociations::Association association;
+    association.window = "*other WINDOW*";
+    association.sequence = "other";
+    m_entry1->autoTypeAssociations()->add(association);
+
+    m_autoType->performGlobalAutoType(m_dbList);
+    QCOMPARE(m_test->actionChars(), QString("other"));
+
+    // a removed association no longer matches
+    m_test->clearActions();
+    m_entry1->autoTypeAssociations()->remove(m_entry1->autoTypeAssociations()->size() - 1);
+    MessageBox::setNextAnswer(QMessageBox::Ok);
+    m_autoType->performGlobalAutoType(m_dbList);
+    QCOMPARE(m_test->actionChars(), QString());
+
+    // so does a new entry
+    Entry* entry = new Entry();
+    entry->setGroup(m_group);
+    entry->setPassword("new");
+    association.sequence = "{PASSWORD}";
+    entry->autoTypeAssociations()->add(association);
+
+    m_autoType->performGlobalAutoType(m_dbList);
+    QCOMPARE(m_test->actionChars(), QString("new"));
+}
+
 void TestAutoType::testGlobalAutoTypeTitleMatch()
 {
     config()->set("AutoTypeEntryTitleMatch", true);
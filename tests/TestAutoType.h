@@ -41,6 +41,7 @@ private slots:
     void testSingleAutoType();
     void testGlobalAutoTypeWithNoMatch();
     void testGlobalAutoTypeWithOneMatch();
+    void testGlobalAutoTypeIndexUpdate();
     void testGlobalAutoTypeTitleMatch();
     void testGlobalAutoTypeUrlMatch();
     void testGlobalAutoTypeUrlSubdomainMatch();
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestBrowserHostIndex.h"
+#include "TestGlobal.h"
+
+#include "browser/BrowserHostIndex.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "crypto/Crypto.h"
+
+QTEST_GUILESS_MAIN(TestBrowserHostIndex)
+
+namespace
+{
+    QList<Entry*> lookupEntries(BrowserHostIndex& index, const QString& hostname, const QString& baseDomain)
+    {
+        QList<Entry*> entries;
+        for (const BrowserHostIndex::Match& match : index.lookup(hostname, baseDomain)) {
+            entries.append(match.entry);
+        }
+        return entries;
+    }
+} // namespace
+
+void TestBrowserHostIndex::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestBrowserHostIndex::init()
+{
+    m_db = new Database();
+    m_db->setRootGroup(new Group());
+}
+
+void TestBrowserHostIndex::cleanup()
+{
+    delete m_db;
+}
+
+Entry* TestBrowserHostIndex::addEntry(Group* group, const QString& url)
+{
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setUrl(url);
+    entry->setGroup(group);
+    return entry;
+}
+
+void TestBrowserHostIndex::testParentDomains()
+{
+    Group* root = m_db->rootGroup();
+    Entry* parent = addEntry(root, "https://example.co.uk");
+    Entry* host = addEntry(root, "https://www.example.co.uk:8443/login");
+    addEntry(root, "https://co.uk");
+    addEntry(root, "https://other.example.co.uk");
+
+    BrowserHostIndex index(m_db);
+
+    // the lookup walks up to the registrable domain, but not beyond
+    const QList<BrowserHostIndex::Match> matches = index.lookup("www.example.co.uk", "example.co.uk");
+    QCOMPARE(matches.size(), 2);
+    QCOMPARE(matches.at(0).entry, parent);
+    QCOMPARE(matches.at(0).scheme, QString("https"));
+    QCOMPARE(matches.at(0).port, -1);
+    QCOMPARE(matches.at(1).entry, host);
+    QCOMPARE(matches.at(1).port, 8443);
+
+    QCOMPARE(lookupEntries(index, "example.co.uk", "example.co.uk"), QList<Entry*>() << parent);
+    QCOMPARE(lookupEntries(index, "WWW.Example.co.uk", "example.co.uk"), QList<Entry*>() << parent << host);
+
+    // without a base domain only the host itself is looked up
+    QCOMPARE(lookupEntries(index, "www.example.co.uk", ""), QList<Entry*>() << host);
+}
+
+void TestBrowserHostIndex::testLabelBoundary()
+{
+    Group* root = m_db->rootGroup();
+    addEntry(root, "https://ample.com");
+    Entry* example = addEntry(root, "https://example.com");
+    addEntry(root, "https://notexample.com");
+
+    BrowserHostIndex index(m_db);
+
+    // hosts only match on whole domain labels
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << example);
+    QCOMPARE(lookupEntries(index, "login.example.com", "example.com"), QList<Entry*>() << example);
+    QVERIFY(lookupEntries(index, "xample.com", "xample.com").isEmpty());
+}
+
+void TestBrowserHostIndex::testUrlWithoutScheme()
+{
+    Group* root = m_db->rootGroup();
+    Entry* noScheme = addEntry(root, "example.org/login");
+    addEntry(root, "myexample.org");
+    addEntry(root, "");
+
+    BrowserHostIndex index(m_db);
+
+    // URLs without a scheme are matched by their host instead of by substring
+    const QList<BrowserHostIndex::Match> matches = index.lookup("www.example.org", "example.org");
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches.at(0).entry, noScheme);
+    QVERIFY(matches.at(0).scheme.isEmpty());
+}
+
+void TestBrowserHostIndex::testSearchingDisabled()
+{
+    Group* root = m_db->rootGroup();
+    auto disabled = new Group();
+    disabled->setUuid(QUuid::createUuid());
+    disabled->setSearchingEnabled(Group::Disable);
+    disabled->setParent(root);
+    auto enabledChild = new Group();
+    enabledChild->setUuid(QUuid::createUuid());
+    enabledChild->setSearchingEnabled(Group::Enable);
+    enabledChild->setParent(disabled);
+
+    Entry* visible = addEntry(root, "https://example.com");
+    Entry* hidden = addEntry(disabled, "https://example.com");
+    Entry* hiddenChild = addEntry(enabledChild, "https://example.com");
+
+    BrowserHostIndex index(m_db);
+
+    // like EntrySearcher, the children of a disabled group are skipped as well
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << visible);
+
+    disabled->setSearchingEnabled(Group::Inherit);
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << visible << hidden << hiddenChild);
+
+    enabledChild->setSearchingEnabled(Group::Disable);
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << visible << hidden);
+
+    // other changes to a group keep the index
+    disabled->setName("Renamed");
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << visible << hidden);
+}
+
+void TestBrowserHostIndex::testUrlChange()
+{
+    Group* root = m_db->rootGroup();
+    Entry* first = addEntry(root, "https://example.com");
+    Entry* second = addEntry(root, "https://example.net");
+    Entry* third = addEntry(root, "https://example.com");
+
+    BrowserHostIndex index(m_db);
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << first << third);
+
+    // the entry is re-indexed under its new host, in its place among the others
+    second->setUrl("https://www.example.com");
+    QCOMPARE(lookupEntries(index, "www.example.com", "example.com"), QList<Entry*>() << first << second << third);
+    QVERIFY(lookupEntries(index, "example.net", "example.net").isEmpty());
+
+    first->setUrl("https://example.net:8080");
+    QCOMPARE(lookupEntries(index, "www.example.com", "example.com"), QList<Entry*>() << second << third);
+    const QList<BrowserHostIndex::Match> matches = index.lookup("example.net", "example.net");
+    QCOMPARE(matches.size(), 1);
+    QCOMPARE(matches.at(0).entry, first);
+    QCOMPARE(matches.at(0).port, 8080);
+
+    // changes other than the URL leave the entry in place
+    third->setTitle("Title");
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << third);
+}
+
+void TestBrowserHostIndex::testStructureChange()
+{
+    Group* root = m_db->rootGroup();
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(root);
+    Entry* first = addEntry(root, "https://example.com");
+
+    BrowserHostIndex index(m_db);
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << first);
+
+    Entry* added = addEntry(group, "https://example.com");
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << first << added);
+
+    delete first;
+    QCOMPARE(lookupEntries(index, "example.com", "example.com"), QList<Entry*>() << added);
+
+    // a moved entry is found in its new place and still updated
+    added->setGroup(root);
+    added->setUrl("https://example.org");
+    QVERIFY(lookupEntries(index, "example.com", "example.com").isEmpty());
+    QCOMPARE(lookupEntries(index, "example.org", "example.org"), QList<Entry*>() << added);
+
+    delete group;
+    QCOMPARE(lookupEntries(index, "example.org", "example.org"), QList<Entry*>() << added);
+}
@@ -33,6 +33,8 @@
 #include "cli/Command.h"
 #include "cli/Utils.h"
 #include "cli/Add.h"
+#include "cli/Analyze.h"
+#include "cli/Batch.h"
 #include "cli/Clip.h"
 #include "cli/Diceware.h"
 #include "cli/Edit.h"
@@ -43,10 +45,17 @@
 #include "cli/Locate.h"
 #include "cli/Merge.h"
 #include "cli/Remove.h"
+#include "cli/DatabaseServer.h"
+#include "cli/Serve.h"
 #include "cli/Show.h"
 
 #include <QFile>
 #include <QClipboard>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QSignalSpy>
+#include <QtEndian>
 #include <QFuture>
 #include <QtConcurrent>
 #include <QSet>
@@ -136,8 +145,10 @@ QSharedPointer<Database> TestCli::readTestDatabase() const
 
 void TestCli::testCommand()
 {
-    QCOMPARE(Command::getCommands().size(), 12);
+    QCOMPARE(Command::getCommands().size(), 15);
     QVERIFY(Command::getCommand("add"));
+    QVERIFY(Command::getCommand("analyze"));
+    QVERIFY(Command::getCommand("batch"));
     QVERIFY(Command::getCommand("clip"));
     QVERIFY(Command::getCommand("diceware"));
     QVERIFY(Command::getCommand("edit"));
@@ -148,6 +159,7 @@ void TestCli::testCommand()
     QVERIFY(Command::getCommand("ls"));
     QVERIFY(Command::getCommand("merge"));
     QVERIFY(Command::getCommand("rm"));
+    QVERIFY(Command::getCommand("serve"));
     QVERIFY(Command::getCommand("show"));
     QVERIFY(!Command::getCommand("doesnotexist"));
 }
@@ -194,6 +206,86 @@ bool isTOTP(const QString & value) {
     return true;
 }
 
+void TestCli::testAnalyze()
+{
+    Analyze analyzeCmd;
+    QVERIFY(!analyzeCmd.name.isEmpty());
+    QVERIFY(analyzeCmd.getDescriptionLine().contains(analyzeCmd.name));
+
+    // write a database with a weak password used by two entries
+    auto db = readTestDatabase();
+    QVERIFY(db);
+    auto* group = db->rootGroup()->findGroupByPath("/General/");
+    QVERIFY(group);
+    for (const QString& title : {QString("Weak Entry"), QString("Reused Entry")}) {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(title);
+        entry->setPassword("password");
+        group->addEntry(entry);
+    }
+    TemporaryFile tmpFile;
+    tmpFile.open();
+    Kdbx4Writer writer;
+    writer.writeDatabase(&tmpFile, db.data());
+    tmpFile.close();
+
+    qint64 pos = m_stdoutFile->pos();
+    Utils::Test::setNextPassword("a");
+    analyzeCmd.execute({"analyze", tmpFile.fileName()});
+    m_stdoutFile->seek(pos);
+    m_stdoutFile->readLine();   // skip password prompt
+    QByteArray output = m_stdoutFile->readAll();
+    QVERIFY(output.contains("/General/Weak Entry: Poor password (1.00 bits), Password used by 2 entries\n"));
+    QVERIFY(output.contains("/General/Reused Entry: Poor password (1.00 bits), Password used by 2 entries\n"));
+}
+
+void TestCli::testBatch()
+{
+    Batch batchCmd;
+    QVERIFY(!batchCmd.name.isEmpty());
+    QVERIFY(batchCmd.getDescriptionLine().contains(batchCmd.name));
+
+    m_stdinFile->write("show -a Title \"/Sample Entry\"\n"
+                       "\n"
+                       "# comment\n"
+                       "locate Sample\n"
+                       "show -a UserName -a URL '/Sample Entry'\n");
+    m_stdinFile->flush();
+    rewind(m_stdinHandle);
+
+    Utils::Test::setNextPassword("a");
+    QCOMPARE(batchCmd.execute({"batch", m_dbFile->fileName()}), EXIT_SUCCESS);
+    m_stdoutFile->reset();
+    m_stdoutFile->readLine();   // skip password prompt
+    QCOMPARE(m_stdoutFile->readAll(), QByteArray("Sample Entry\n"
+                                                 "/Sample Entry\n"
+                                                 "User Name\n"
+                                                 "http://www.somesite.com/\n"));
+
+    // failing or unavailable commands do not stop the batch, but are reported
+    qint64 pos = m_stdoutFile->pos();
+    m_stdinFile->resize(0);
+    m_stdinFile->write("rm /Sample\\ Entry\n"
+                       "doesnotexist\n"
+                       "locate \"Does Not Exist\"\n"
+                       "show -a Password /Sample\\ Entry\n"
+                       "exit\n"
+                       "show -a Title \"/Sample Entry\"\n");
+    m_stdinFile->flush();
+    rewind(m_stdinHandle);
+
+    Utils::Test::setNextPassword("a");
+    QCOMPARE(batchCmd.execute({"batch", m_dbFile->fileName()}), EXIT_FAILURE);
+    m_stdoutFile->seek(pos);
+    m_stdoutFile->readLine();   // skip password prompt
+    QCOMPARE(m_stdoutFile->readAll(), QByteArray("Password\n"));
+    m_stderrFile->reset();
+    QCOMPARE(m_stderrFile->readAll(), QByteArray("Command rm is not available in batch mode.\n"
+                                                 "Invalid command doesnotexist.\n"
+                                                 "No results for that search term.\n"));
+}
+
 void TestCli::testClip()
 {
     QClipboard* clipboard = QGuiApplication::clipboard();
@@ -775,6 +867,93 @@ void TestCli::testRemove()
     QCOMPARE(m_stderrFile->readAll(), QByteArray("Entry /Sample Entry not found.\n"));
 }
 
+void TestCli::testServe()
+{
+    Serve serveCmd;
+    QVERIFY(!serveCmd.name.isEmpty());
+    QVERIFY(serveCmd.getDescriptionLine().contains(serveCmd.name));
+
+    Utils::Test::setNextPassword("a");
+    DatabaseServer server(Database::unlockFromStdin(m_dbFile->fileName(), "", m_stdoutHandle));
+    QSignalSpy lockedSpy(&server, SIGNAL(locked()));
+
+    QJsonObject request;
+    request["action"] = "attribute";
+    request["entry"] = "/Sample Entry";
+    request["attribute"] = "UserName";
+    QJsonObject reply = server.handleRequest(request);
+    QVERIFY(reply["success"].toBool());
+    QCOMPARE(reply["value"].toString(), QString("User Name"));
+
+    request["entry"] = "/Does Not Exist";
+    reply = server.handleRequest(request);
+    QVERIFY(!reply["success"].toBool());
+    QVERIFY(!reply["error"].toString().isEmpty());
+
+    request = QJsonObject();
+    request["action"] = "show";
+    request["entry"] = "/Sample Entry";
+    reply = server.handleRequest(request);
+    QVERIFY(reply["success"].toBool());
+    QJsonObject attributes = reply["attributes"].toObject();
+    QCOMPARE(attributes.size(), EntryAttributes::DefaultAttributes.size());
+    QCOMPARE(attributes["Password"].toString(), QString("Password"));
+    QCOMPARE(attributes["URL"].toString(), QString("http://www.somesite.com/"));
+
+    request = QJsonObject();
+    request["action"] = "locate";
+    request["term"] = "Sample";
+    reply = server.handleRequest(request);
+    QCOMPARE(reply["entries"].toArray(), QJsonArray::fromStringList({"/Sample Entry"}));
+
+    request = QJsonObject();
+    request["action"] = "list";
+    reply = server.handleRequest(request);
+    QVERIFY(reply["success"].toBool());
+    QCOMPARE(reply["entries"].toArray(), QJsonArray::fromStringList({"/Sample Entry"}));
+    QVERIFY(reply["groups"].toArray().toVariantList().contains(QString("/General/")));
+
+    request["action"] = "doesnotexist";
+    QVERIFY(!server.handleRequest(request)["success"].toBool());
+
+    // round trip over the local socket
+    TemporaryFile socketFile;
+    QVERIFY(socketFile.open());
+    const QString serverPath = socketFile.fileName() + ".socket";
+    QVERIFY2(server.listen(serverPath), qPrintable(server.errorString()));
+
+    QLocalSocket socket;
+    socket.connectToServer(serverPath);
+    QVERIFY(socket.waitForConnected(1000));
+
+    request = QJsonObject();
+    request["action"] = "attribute";
+    request["entry"] = "/Sample Entry";
+    request["attribute"] = "Password";
+    QByteArray message = QJsonDocument(request).toJson(QJsonDocument::Compact);
+    uchar header[4];
+    qToLittleEndian<quint32>(static_cast<quint32>(message.size()), header);
+    socket.write(reinterpret_cast<const char*>(header), 4);
+    socket.write(message);
+    socket.flush();
+
+    QTRY_VERIFY(socket.bytesAvailable() >= 4);
+    QByteArray replyHeader = socket.peek(4);
+    const quint32 length = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(replyHeader.constData()));
+    QTRY_VERIFY(socket.bytesAvailable() >= qint64(length) + 4);
+    socket.read(4);
+    reply = QJsonDocument::fromJson(socket.read(length)).object();
+    QVERIFY(reply["success"].toBool());
+    QCOMPARE(reply["value"].toString(), QString("Password"));
+
+    // lock on inactivity
+    server.setLockTimeout(100);
+    QTRY_COMPARE(lockedSpy.count(), 1);
+    QTRY_COMPARE(socket.state(), QLocalSocket::UnconnectedState);
+    request["action"] = "locate";
+    QVERIFY(!server.handleRequest(request)["success"].toBool());
+}
+
 void TestCli::testShow()
 {
     Show showCmd;
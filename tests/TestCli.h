@@ -42,6 +42,8 @@ private slots:
 
     void testCommand();
     void testAdd();
+    void testAnalyze();
+    void testBatch();
     void testClip();
     void testDiceware();
     void testEdit();
@@ -54,6 +56,7 @@ private slots:
     void testLocate();
     void testMerge();
     void testRemove();
+    void testServe();
     void testShow();
 
 private:
@@ -23,6 +23,8 @@
 #include <QTemporaryFile>
 
 #include "config-keepassx-tests.h"
+#include "core/DatabaseOpenScheduler.h"
+#include "core/Global.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
 #include "format/KeePass2Writer.h"
@@ -101,3 +103,58 @@ void TestDatabase::testEmptyRecycleBinWithHierarchicalData()
     writer.writeDatabase(&afterCleanup, db.data());
     QVERIFY(afterCleanup.size() < initialSize);
 }
+
+void TestDatabase::testOpenScheduler()
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("123"));
+    auto wrongKey = QSharedPointer<CompositeKey>::create();
+    wrongKey->addKey(QSharedPointer<PasswordKey>::create("wrong"));
+
+    const QStringList fileNames = {QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinDisabled.kdbx"),
+                                   QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinEmpty.kdbx"),
+                                   QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinWithData.kdbx")};
+    const QString failingFileName = QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinNotYetCreated.kdbx");
+
+    DatabaseOpenScheduler scheduler;
+    scheduler.setMaxThreadCount(2);
+    // a budget too small for any job must still process the jobs one by one
+    scheduler.setMemoryBudget(1);
+    QVERIFY(scheduler.isIdle());
+
+    qRegisterMetaType<Database*>();
+    QSignalSpy spyOpened(&scheduler, SIGNAL(databaseOpened(QString,Database*)));
+    QSignalSpy spyFailed(&scheduler, SIGNAL(databaseOpenFailed(QString,QString)));
+
+    for (const QString& fileName : fileNames) {
+        scheduler.open(fileName, key);
+    }
+    scheduler.open(failingFileName, wrongKey);
+    QVERIFY(!scheduler.isIdle());
+    QVERIFY(scheduler.isPending(failingFileName));
+
+    QTRY_VERIFY_WITH_TIMEOUT(scheduler.isIdle(), 30000);
+    QCOMPARE(spyOpened.count(), fileNames.size());
+    QCOMPARE(spyFailed.count(), 1);
+    QCOMPARE(spyFailed.first().at(0).toString(), failingFileName);
+    QVERIFY(!spyFailed.first().at(1).toString().isEmpty());
+
+    QStringList openedFileNames;
+    for (const auto& args : asConst(spyOpened)) {
+        openedFileNames << args.at(0).toString();
+        QScopedPointer<Database> db(args.at(1).value<Database*>());
+        QVERIFY(db);
+        QCOMPARE(db->thread(), thread());
+        QVERIFY(db->rootGroup());
+        QVERIFY(db->hasKey());
+        // history items are not children of the database and must be moved as well
+        for (const Entry* entry : db->rootGroup()->entriesRecursive(true)) {
+            QCOMPARE(entry->thread(), thread());
+            QCOMPARE(entry->attributes()->thread(), thread());
+        }
+    }
+    openedFileNames.sort();
+    QStringList expectedFileNames = fileNames;
+    expectedFileNames.sort();
+    QCOMPARE(openedFileNames, expectedFileNames);
+}
@@ -31,6 +31,7 @@ private slots:
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
+    void testOpenScheduler();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
@@ -142,6 +142,70 @@ void TestEntry::testClone()
     QCOMPARE(entryClonePassRef->resolvePlaceholder(entryCloneUserRef->password()), entryOrg->password());
 }
 
+void TestEntry::testContentDigest()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    entry->setUuid(QUuid::createUuid());
+    entry->setTitle("Title");
+    entry->setPassword("Password");
+    const QByteArray digest = entry->contentDigest();
+    QCOMPARE(digest.size(), 32);
+    QCOMPARE(entry->contentDigest(), digest);
+
+    // the uuid, times and history are not part of the content
+    QScopedPointer<Entry> clone(entry->clone(Entry::CloneNewUuid | Entry::CloneResetTimeInfo));
+    QCOMPARE(clone->contentDigest(), digest);
+    clone->setExpires(true);
+    QCOMPARE(clone->contentDigest(), digest);
+
+    // every kind of content invalidates the digest
+    entry->setPassword("Other");
+    QVERIFY(entry->contentDigest() != digest);
+    entry->setPassword("Password");
+    QCOMPARE(entry->contentDigest(), digest);
+
+    entry->attributes()->set("Custom", "Value", true);
+    const QByteArray attributeDigest = entry->contentDigest();
+    QVERIFY(attributeDigest != digest);
+    entry->attributes()->set("Custom", "Value", false);
+    QVERIFY(entry->contentDigest() != attributeDigest);
+    entry->attributes()->remove("Custom");
+    QCOMPARE(entry->contentDigest(), digest);
+
+    entry->attachments()->set("file.txt", QByteArray("content"));
+    QVERIFY(entry->contentDigest() != digest);
+    entry->attachments()->remove("file.txt");
+    QCOMPARE(entry->contentDigest(), digest);
+
+    entry->autoTypeAssociations()->add({"Window", "{PASSWORD}"});
+    QVERIFY(entry->contentDigest() != digest);
+    entry->autoTypeAssociations()->clear();
+    QCOMPARE(entry->contentDigest(), digest);
+
+    entry->customData()->set("Key", "Value");
+    QVERIFY(entry->contentDigest() != digest);
+    entry->customData()->remove("Key");
+    QCOMPARE(entry->contentDigest(), digest);
+
+    entry->setIcon(5);
+    QVERIFY(entry->contentDigest() != digest);
+
+    // the order custom data was added in does not matter
+    QScopedPointer<Entry> forward(new Entry());
+    QScopedPointer<Entry> backward(new Entry());
+    const int customDataCount = 32;
+    for (int i = 0; i < customDataCount; ++i) {
+        forward->customData()->set(QString("Key%1").arg(i), QString("Value%1").arg(i));
+        const int j = customDataCount - 1 - i;
+        backward->customData()->set(QString("Key%1").arg(j), QString("Value%1").arg(j));
+    }
+    QCOMPARE(backward->contentDigest(), forward->contentDigest());
+
+    QScopedPointer<Entry> copy(new Entry());
+    copy->copyDataFrom(entry.data());
+    QCOMPARE(copy->contentDigest(), entry->contentDigest());
+}
+
 void TestEntry::testResolveUrl()
 {
     QScopedPointer<Entry> entry(new Entry());
@@ -174,6 +238,78 @@ void TestEntry::testResolveUrl()
     QCOMPARE(entry->resolveUrl(noUrl), QString(""));
 }
 
+void TestEntry::testParsedUrl()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    entry->setUrl("https://Login.Example.co.uk:8443/path?query");
+
+    EntryUrl url = entry->parsedUrl();
+    QCOMPARE(url.url, QUrl("https://Login.Example.co.uk:8443/path?query"));
+    QCOMPARE(url.scheme, QString("https"));
+    QCOMPARE(url.host, QString("login.example.co.uk"));
+    QCOMPARE(url.port, 8443);
+    QCOMPARE(url.registrableDomain, QString("example.co.uk"));
+    QCOMPARE(url.webUrl, entry->resolveUrl(entry->url()));
+    QCOMPARE(entry->webUrl(), url.webUrl);
+
+    // URLs without a scheme are parsed as user input
+    entry->setUrl("www.example.com/login");
+    url = entry->parsedUrl();
+    QCOMPARE(url.scheme, QString());
+    QCOMPARE(url.host, QString("www.example.com"));
+    QCOMPARE(url.port, -1);
+    QCOMPARE(url.registrableDomain, QString("example.com"));
+    QCOMPARE(entry->webUrl(), QString("https://www.example.com/login"));
+
+    // changing the attribute directly invalidates the cache as well
+    entry->attributes()->set(EntryAttributes::URLKey, "http://other.org");
+    url = entry->parsedUrl();
+    QCOMPARE(url.host, QString("other.org"));
+    QCOMPARE(url.registrableDomain, QString("other.org"));
+
+    entry->setUrl("");
+    url = entry->parsedUrl();
+    QVERIFY(url.host.isEmpty());
+    QVERIFY(url.registrableDomain.isEmpty());
+    QVERIFY(entry->webUrl().isEmpty());
+
+    // placeholders are resolved by webUrl() only
+    entry->setTitle("example.net");
+    entry->setUrl("{TITLE}");
+    QCOMPARE(entry->webUrl(), QString("https://example.net"));
+}
+
+void TestEntry::benchmarkParsedUrl()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 1000; ++i) {
+        auto* entry = new Entry();
+        entry->setUrl(QString("https://login%1.example.com:8443/path").arg(i));
+        entries.append(entry);
+    }
+
+    int matches = 0;
+    QBENCHMARK
+    {
+        matches = 0;
+        for (const Entry* entry : asConst(entries)) {
+            const EntryUrl url = entry->parsedUrl();
+            if (url.port == 8443 && url.registrableDomain == "example.com") {
+                ++matches;
+            }
+        }
+    }
+    QCOMPARE(matches, entries.size());
+
+    qDeleteAll(entries);
+}
+
 void TestEntry::testResolveUrlPlaceholders()
 {
     Entry entry;
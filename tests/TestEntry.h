@@ -31,7 +31,10 @@ private slots:
     void testHistoryItemDeletion();
     void testCopyDataFrom();
     void testClone();
+    void testContentDigest();
     void testResolveUrl();
+    void testParsedUrl();
+    void benchmarkParsedUrl();
     void testResolveUrlPlaceholders();
     void testResolveRecursivePlaceholders();
     void testResolveReferencePlaceholders();
@@ -20,6 +20,7 @@
 
 #include <QSignalSpy>
 
+#include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Entry.h"
 #include "core/Group.h"
@@ -31,6 +32,7 @@
 #include "gui/entry/EntryAttributesModel.h"
 #include "gui/entry/EntryModel.h"
 #include "modeltest.h"
+#include "totp/totp.h"
 
 QTEST_GUILESS_MAIN(TestEntryModel)
 
@@ -102,6 +104,151 @@ void TestEntryModel::test()
     delete model;
 }
 
+void TestEntryModel::testBulkUpdate()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+    Group* group2 = new Group();
+    group2->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setGroup(group1);
+
+    EntryModel* model = new EntryModel(this);
+    ModelTest* modelTest = new ModelTest(model, this);
+    model->setGroup(group1);
+
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+    QSignalSpy spyAboutToAdd(model, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)));
+    QSignalSpy spyAboutToRemove(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)));
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+    db->beginBulkUpdate();
+    for (int i = 0; i < 10; ++i) {
+        Entry* entry = new Entry();
+        entry->setGroup(group1);
+        entry->setTitle(QString("entry%1").arg(i));
+    }
+    entry1->setGroup(group2);
+    db->endBulkUpdate();
+
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyAboutToAdd.count(), 0);
+    QCOMPARE(spyAboutToRemove.count(), 0);
+    QCOMPARE(spyDataChanged.count(), 0);
+    QCOMPARE(model->rowCount(), 10);
+
+    // the shown group is deleted during the update
+    db->beginBulkUpdate();
+    delete group1;
+    db->endBulkUpdate();
+
+    QCOMPARE(spyReset.count(), 2);
+    QCOMPARE(model->rowCount(), 0);
+
+    model->setGroup(group2);
+    QCOMPARE(model->rowCount(), 1);
+
+    delete modelTest;
+    delete model;
+    delete db;
+}
+
+void TestEntryModel::testDisplayCache()
+{
+    Database* db = new Database();
+    Entry* entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(db->rootGroup());
+    entry1->setTitle("original");
+    entry1->setUsername("user");
+
+    Entry* entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setGroup(db->rootGroup());
+    entry2->setUsername(QString("{REF:U@I:%1}").arg(entry1->uuidToHex()));
+
+    EntryModel* model = new EntryModel(this);
+    model->setDisplayCacheRows(1);
+    model->setGroup(db->rootGroup());
+
+    QModelIndex title1 = model->indexFromEntry(entry1);
+    QModelIndex username2 = model->index(model->indexFromEntry(entry2).row(), EntryModel::Username);
+    QCOMPARE(model->data(title1).toString(), QString("original"));
+    QCOMPARE(model->data(username2).toString(), QString("Ref: user"));
+
+    entry1->setTitle("changed");
+    QCOMPARE(model->data(title1).toString(), QString("changed"));
+
+    // strings resolved through references follow the referenced entry
+    entry1->setUsername("other");
+    QCOMPARE(model->data(username2).toString(), QString("Ref: other"));
+
+    // references to entries in groups that are not shown are followed as well
+    Group* otherGroup = new Group();
+    otherGroup->setUuid(QUuid::createUuid());
+    otherGroup->setParent(db->rootGroup());
+    Entry* entry3 = new Entry();
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setGroup(otherGroup);
+    entry3->setUsername("elsewhere");
+    entry2->setPassword(QString("{REF:U@I:%1}").arg(entry3->uuidToHex()));
+    model->setPasswordsHidden(false);
+
+    QModelIndex password2 = model->index(username2.row(), EntryModel::Password);
+    QCOMPARE(model->data(password2).toString(), QString("Ref: elsewhere"));
+
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    entry3->setUsername("moved");
+    QVERIFY(!spyDataChanged.isEmpty());
+    QCOMPARE(spyDataChanged.last().at(0).value<QModelIndex>().row(), username2.row());
+    QCOMPARE(model->data(password2).toString(), QString("Ref: moved"));
+
+    model->setUsernamesHidden(true);
+    QVERIFY(model->data(username2).toString() != QString("Ref: other"));
+
+    delete model;
+    delete db;
+}
+
+void TestEntryModel::testTotpColumn()
+{
+    Database* db = new Database();
+    Entry* entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(db->rootGroup());
+    entry1->setTotp(Totp::createSettings("GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ", 6, 30));
+
+    Entry* entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setGroup(db->rootGroup());
+
+    EntryModel* model = new EntryModel(this);
+    model->setGroup(db->rootGroup());
+
+    QModelIndex totp1 = model->index(model->indexFromEntry(entry1).row(), EntryModel::Totp);
+    QModelIndex totp2 = model->index(model->indexFromEntry(entry2).row(), EntryModel::Totp);
+    QCOMPARE(model->data(totp1).toString(), entry1->totp());
+    QCOMPARE(model->data(totp2).toString(), QString());
+
+    // displayed codes are refreshed together and reported as one range
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QVERIFY(QMetaObject::invokeMethod(model, "refreshTotpCodes"));
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged.at(0).at(0).value<QModelIndex>(), totp1);
+    QCOMPARE(spyDataChanged.at(0).at(1).value<QModelIndex>(), totp1);
+    QCOMPARE(model->data(totp1).toString(), entry1->totp());
+
+    // codes that are no longer displayed are not refreshed
+    QVERIFY(QMetaObject::invokeMethod(model, "refreshTotpCodes"));
+    QVERIFY(QMetaObject::invokeMethod(model, "refreshTotpCodes"));
+    QCOMPARE(spyDataChanged.count(), 2);
+
+    delete model;
+    delete db;
+}
+
 void TestEntryModel::testAttachmentsModel()
 {
     EntryAttachments* entryAttachments = new EntryAttachments(this);
@@ -330,6 +477,49 @@ void TestEntryModel::testProxyModel()
     delete db;
 }
 
+void TestEntryModel::testProxySortKeys()
+{
+    Database* db = new Database();
+    const QStringList titles = {"b", "a", "c"};
+    for (const QString& title : titles) {
+        Entry* entry = new Entry();
+        entry->setTitle(title);
+        entry->setGroup(db->rootGroup());
+    }
+
+    EntryModel* modelSource = new EntryModel(this);
+    SortFilterHideProxyModel* modelProxy = new SortFilterHideProxyModel(this);
+    modelProxy->setSourceModel(modelSource);
+    modelProxy->setDynamicSortFilter(true);
+    modelProxy->setSortLocaleAware(true);
+    modelProxy->setSortCaseSensitivity(Qt::CaseInsensitive);
+    modelProxy->setSortRole(Qt::UserRole);
+    modelSource->setGroup(db->rootGroup());
+    modelProxy->sort(EntryModel::Title, Qt::AscendingOrder);
+
+    auto proxyTitles = [modelProxy]() {
+        QStringList result;
+        for (int row = 0; row < modelProxy->rowCount(); ++row) {
+            result << modelProxy->index(row, EntryModel::Title).data().toString();
+        }
+        return result;
+    };
+    QCOMPARE(proxyTitles(), QStringList({"a", "b", "c"}));
+
+    // changed entries are sorted with new keys
+    db->rootGroup()->entries().at(1)->setTitle("d");
+    QCOMPARE(proxyTitles(), QStringList({"b", "c", "d"}));
+
+    Entry* entry = new Entry();
+    entry->setTitle("b2");
+    entry->setGroup(db->rootGroup());
+    QCOMPARE(proxyTitles(), QStringList({"b", "b2", "c", "d"}));
+
+    delete modelProxy;
+    delete modelSource;
+    delete db;
+}
+
 void TestEntryModel::testDatabaseDelete()
 {
     EntryModel* model = new EntryModel(this);
@@ -27,12 +27,16 @@ class TestEntryModel : public QObject
 private slots:
     void initTestCase();
     void test();
+    void testBulkUpdate();
+    void testDisplayCache();
+    void testTotpColumn();
     void testAttachmentsModel();
     void testAttributesModel();
     void testDefaultIconModel();
     void testCustomIconModel();
     void testAutoTypeAssociationsModel();
     void testProxyModel();
+    void testProxySortKeys();
     void testDatabaseDelete();
 };
 
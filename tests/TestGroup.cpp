@@ -125,6 +125,45 @@ void TestGroup::testParenting()
     delete tmpRoot;
 }
 
+void TestGroup::testIndexInParent()
+{
+    QScopedPointer<Database> db(new Database());
+    Group* root = db->rootGroup();
+    Group* other = new Group();
+    other->setParent(root);
+
+    QList<Group*> groups;
+    for (int i = 0; i < 5; ++i) {
+        auto* group = new Group();
+        group->setParent(root);
+        groups.append(group);
+    }
+
+    auto verifyIndexes = [](const Group* parent) {
+        for (int i = 0; i < parent->children().size(); ++i) {
+            QCOMPARE(parent->children().at(i)->indexInParent(), i);
+        }
+    };
+
+    QCOMPARE(root->indexInParent(), -1);
+    verifyIndexes(root);
+
+    groups[1]->setParent(root, 4);
+    verifyIndexes(root);
+    groups[4]->setParent(root, 0);
+    verifyIndexes(root);
+    groups[2]->setParent(other);
+    verifyIndexes(root);
+    verifyIndexes(other);
+    delete groups[0];
+    verifyIndexes(root);
+
+    QScopedPointer<Group> detached(new Group());
+    groups[3]->setParent(detached.data());
+    verifyIndexes(root);
+    QCOMPARE(groups[3]->indexInParent(), 0);
+}
+
 void TestGroup::testSignals()
 {
     Database* db = new Database();
@@ -31,6 +31,7 @@ private slots:
     void init();
     void cleanup();
     void testParenting();
+    void testIndexInParent();
     void testSignals();
     void testEntries();
     void testDeleteSignals();
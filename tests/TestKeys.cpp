@@ -23,10 +23,12 @@
 
 #include "config-keepassx-tests.h"
 
+#include "core/Clock.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
 #include "crypto/CryptoHash.h"
 #include "crypto/kdf/AesKdf.h"
+#include "crypto/kdf/Argon2Kdf.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "keys/FileKey.h"
@@ -301,3 +303,107 @@ void TestKeys::testCompositeKeyComponents()
     db2.reset(reader.readDatabase(&buffer, compositeKeyDec4));
     QVERIFY(reader.hasError());
 }
+
+void TestKeys::testKdfBenchmark()
+{
+    Argon2Kdf kdf;
+    QVERIFY(kdf.setMemory(1 << 10));
+    QVERIFY(kdf.setParallelism(1));
+
+    QVERIFY(kdf.benchmark(200) >= 1);
+
+    // the calibration must be cached for this parameter set
+    QVariantMap cache = Kdf::calibrationCache();
+    QCOMPARE(cache.size(), 1);
+
+    // replace the measured values with known ones: 1 ms per round, 50 ms overhead
+    const QString key = cache.firstKey();
+    const uint now = Clock::currentSecondsSinceEpoch();
+    cache.insert(key, QVariantList() << 1000000.0 << 50000000.0 << now);
+    Kdf::restoreCalibrationCache(cache);
+    QCOMPARE(kdf.benchmark(1000), 950);
+    QCOMPARE(kdf.benchmark(10), 1);
+
+    // a clone with identical parameters but a different salt shares the calibration
+    auto clone = kdf.clone();
+    clone->randomizeSeed();
+    QCOMPARE(clone->benchmark(1000), 950);
+
+    // changing the memory cost requires a new calibration
+    QVERIFY(kdf.setMemory(2 << 10));
+    QVERIFY(kdf.benchmark(200) >= 1);
+    QCOMPARE(Kdf::calibrationCache().size(), 2);
+
+    // malformed and expired entries are ignored
+    QVariantMap malformed;
+    malformed.insert(key, QVariantList() << -1.0 << 0.0 << now);
+    Kdf::restoreCalibrationCache(malformed);
+    QVariantMap expired;
+    expired.insert(key, QVariantList() << 2000000.0 << 0.0 << now - 365 * 24 * 60 * 60);
+    Kdf::restoreCalibrationCache(expired);
+    QVERIFY(kdf.setMemory(1 << 10));
+    QCOMPARE(kdf.benchmark(1000), 950);
+
+    // an explicit benchmark measures again and replaces the cached calibration
+    QVERIFY(kdf.benchmark(200, true) >= 1);
+    QVERIFY(Kdf::calibrationCache().value(key).toList().at(0).toDouble() != 1000000.0);
+}
+
+void TestKeys::testPrecomputedTransform()
+{
+    auto compositeKey = QSharedPointer<CompositeKey>::create();
+    compositeKey->addKey(QSharedPointer<PasswordKey>::create("password"));
+
+    QScopedPointer<Database> db(new Database());
+    auto kdf = QSharedPointer<Argon2Kdf>::create();
+    kdf->setMemory(1 << 10);
+    kdf->setRounds(2);
+    kdf->randomizeSeed();
+    db->setKdf(kdf);
+    QVERIFY(db->setKey(compositeKey));
+
+    KeePass2Writer writer;
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+    QVERIFY(writer.writeDatabase(&buffer, db.data()));
+
+    // the KDF can be read from the header without a key
+    buffer.seek(0);
+    KeePass2Reader reader;
+    QSharedPointer<Kdf> headerKdf = reader.readKdf(&buffer);
+    QVERIFY(headerKdf);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(headerKdf->writeParameters(), db->kdf()->writeParameters());
+
+    QByteArray transformed;
+    QVERIFY(compositeKey->transform(*headerKdf, transformed));
+    QCOMPARE(transformed, db->transformedMasterKey());
+
+    // a key transformed ahead of time is used for a KDF with identical parameters only
+    auto precomputedKey = QSharedPointer<CompositeKey>::create();
+    precomputedKey->addKey(QSharedPointer<PasswordKey>::create("password"));
+    precomputedKey->setTransformedKey(*headerKdf, transformed);
+
+    buffer.seek(0);
+    QScopedPointer<Database> db2(reader.readDatabase(&buffer, precomputedKey));
+    QVERIFY(db2);
+    QVERIFY(!reader.hasError());
+
+    QByteArray result;
+    QVERIFY(precomputedKey->transform(*headerKdf, result));
+    QCOMPARE(result, transformed);
+
+    auto otherKdf = headerKdf->clone();
+    otherKdf->randomizeSeed();
+    QVERIFY(precomputedKey->transform(*otherKdf, result));
+    QVERIFY(result != transformed);
+
+    // adding key components discards the precomputed transformation
+    precomputedKey->setTransformedKey(*headerKdf, QByteArray(32, '\x01'));
+    QVERIFY(precomputedKey->transform(*headerKdf, result));
+    QCOMPARE(result, QByteArray(32, '\x01'));
+    precomputedKey->addKey(QSharedPointer<PasswordKey>::create("second"));
+    QVERIFY(precomputedKey->transform(*headerKdf, result));
+    QVERIFY(result != QByteArray(32, '\x01'));
+    QVERIFY(result != transformed);
+}
@@ -35,6 +35,8 @@ private slots:
     void testFileKeyHash();
     void testFileKeyError();
     void testCompositeKeyComponents();
+    void testKdfBenchmark();
+    void testPrecomputedTransform();
     void benchmarkTransformKey();
 };
 
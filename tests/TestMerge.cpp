@@ -1388,6 +1388,181 @@ void TestMerge::testMergeModified()
     QVERIFY(!modifiedSignalSpy.empty());
 }
 
+/**
+ * A three-way merge only considers source entries changed since the base,
+ * entries the target already incorporated are left alone.
+ */
+void TestMerge::testThreeWayMerge()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    const QByteArray base = Merger::createBaseManifest(dbDestination.data());
+
+    m_clock->advanceSecond(1);
+
+    // changed in the target only
+    Entry* destinationEntry1 = dbDestination->rootGroup()->findEntryByPath("entry1");
+    QVERIFY(destinationEntry1);
+    destinationEntry1->beginUpdate();
+    destinationEntry1->setPassword("local");
+    destinationEntry1->endUpdate();
+
+    // changed in the source only
+    Entry* sourceEntry2 = dbSource->rootGroup()->findEntryByPath("entry2");
+    QVERIFY(sourceEntry2);
+    sourceEntry2->beginUpdate();
+    sourceEntry2->setPassword("remote");
+    sourceEntry2->endUpdate();
+
+    m_clock->advanceSecond(1);
+
+    QScopedPointer<Database> dbTwoWay(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    Merger twoWayMerger(dbSource.data(), dbTwoWay.data());
+    twoWayMerger.setForcedMergeMode(Group::KeepRemote);
+    QVERIFY(twoWayMerger.merge());
+    // a two-way merge reapplies the unchanged remote entry on top of the local change
+    QCOMPARE(dbTwoWay->rootGroup()->findEntryByPath("entry1")->password(), QString(""));
+    QCOMPARE(dbTwoWay->rootGroup()->findEntryByPath("entry2")->password(), QString("remote"));
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.setForcedMergeMode(Group::KeepRemote);
+    QVERIFY(merger.setBaseManifest(base));
+    QVERIFY(merger.merge());
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry1")->password(), QString("local"));
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry2")->password(), QString("remote"));
+
+    // the base is stored in the custom data of the database
+    QVERIFY(Merger::storedBaseManifest(dbDestination.data()).isEmpty());
+    QVERIFY(Merger::storeBaseManifest(dbDestination.data()));
+    QVERIFY(!Merger::storeBaseManifest(dbDestination.data()));
+    QCOMPARE(Merger::storedBaseManifest(dbDestination.data()), Merger::createBaseManifest(dbDestination.data()));
+
+    Merger invalidMerger(dbSource.data(), dbDestination.data());
+    QVERIFY(!invalidMerger.setBaseManifest("invalid"));
+    QVERIFY(invalidMerger.setBaseManifest(QByteArray()));
+}
+
+void TestMerge::testConcurrentPlanning()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    Entry* sourceEntry2 = dbSource->rootGroup()->findEntryByPath("entry2");
+    QVERIFY(sourceEntry2);
+    sourceEntry2->beginUpdate();
+    sourceEntry2->setPassword("remote");
+    sourceEntry2->endUpdate();
+
+    auto* newEntry = new Entry();
+    newEntry->setUuid(QUuid::createUuid());
+    newEntry->setTitle("entry3");
+    newEntry->setGroup(dbSource->rootGroup());
+
+    m_clock->advanceSecond(1);
+
+    QScopedPointer<Database> dbSerial(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    Merger serialMerger(dbSource.data(), dbSerial.data());
+    QVERIFY(serialMerger.merge());
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.setConcurrentPlanning(true);
+    QVERIFY(merger.merge());
+
+    const QList<Entry*> serialEntries = dbSerial->rootGroup()->entriesRecursive();
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), serialEntries.size());
+    for (const Entry* serialEntry : serialEntries) {
+        const Entry* entry = dbDestination->rootGroup()->findEntryByUuid(serialEntry->uuid());
+        QVERIFY(entry);
+        QVERIFY(entry->equals(serialEntry, CompareItemIgnoreMilliseconds));
+    }
+    QCOMPARE(dbDestination->rootGroup()->findEntryByPath("entry2")->password(), QString("remote"));
+    QVERIFY(dbDestination->rootGroup()->findEntryByPath("entry3"));
+}
+
+void TestMerge::benchmarkMergeLargeDatabases_data()
+{
+    QTest::addColumn<bool>("concurrentPlanning");
+    QTest::newRow("Serial") << false;
+    QTest::newRow("Concurrent") << true;
+}
+
+void TestMerge::benchmarkMergeLargeDatabases()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const int groupCount = 50;
+    const int entriesPerGroup = 1000;
+
+    QScopedPointer<Database> dbDestination(new Database());
+    for (int i = 0; i < groupCount; ++i) {
+        auto* group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(QString("group%1").arg(i));
+        group->setParent(dbDestination->rootGroup());
+        for (int j = 0; j < entriesPerGroup; ++j) {
+            auto* entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setTitle(QString("entry%1").arg(j));
+            entry->setGroup(group);
+        }
+    }
+
+    QScopedPointer<Database> dbSource(
+        createTestDatabaseStructureClone(dbDestination.data(), Entry::CloneNoFlags, Group::CloneIncludeEntries));
+
+    m_clock->advanceSecond(1);
+
+    // update, add and delete a fraction of the entries in the source
+    int added = 0;
+    int deleted = 0;
+    for (Group* group : dbSource->rootGroup()->children()) {
+        const QList<Entry*> entries = group->entries();
+        for (int j = 0; j < entries.size(); j += 10) {
+            entries[j]->beginUpdate();
+            entries[j]->setPassword(QString("password%1").arg(j));
+            entries[j]->endUpdate();
+        }
+        for (int j = 5; j < entries.size(); j += 50) {
+            delete entries[j];
+            ++deleted;
+        }
+        for (int j = 0; j < entriesPerGroup / 50; ++j) {
+            auto* entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setTitle(QString("new%1").arg(j));
+            entry->setGroup(group);
+            ++added;
+        }
+    }
+
+    m_clock->advanceSecond(1);
+
+    QFETCH(bool, concurrentPlanning);
+    Merger merger(dbSource.data(), dbDestination.data());
+    merger.setForcedMergeMode(Group::Synchronize);
+    merger.setConcurrentPlanning(concurrentPlanning);
+    QBENCHMARK_ONCE
+    {
+        QVERIFY(merger.merge());
+    }
+
+    QCOMPARE(dbDestination->rootGroup()->entriesRecursive().size(), groupCount * entriesPerGroup + added - deleted);
+    QCOMPARE(dbDestination->deletedObjects().size(), deleted);
+    Entry* updatedEntry = dbDestination->rootGroup()->findEntryByPath("/group0/entry0");
+    QVERIFY(updatedEntry);
+    QCOMPARE(updatedEntry->password(), QString("password0"));
+}
+
 Database* TestMerge::createTestDatabase()
 {
     Database* db = new Database();
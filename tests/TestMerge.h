@@ -62,6 +62,10 @@ private slots:
     void testDeletedGroup();
     void testDeletedRevertedEntry();
     void testDeletedRevertedGroup();
+    void testThreeWayMerge();
+    void testConcurrentPlanning();
+    void benchmarkMergeLargeDatabases_data();
+    void benchmarkMergeLargeDatabases();
 
 private:
     Database* createTestDatabase();
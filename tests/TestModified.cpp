@@ -618,3 +618,41 @@ void TestModified::testCustomData()
     group->customData()->set("Key", "Value");
     QCOMPARE(spyModified.count(), spyCount);
 }
+
+void TestModified::testBulkUpdate()
+{
+    QScopedPointer<Database> db(new Database());
+    db->setEmitModified(true);
+    QSignalSpy spyModified(db.data(), SIGNAL(modified()));
+    QSignalSpy spyStarted(db.data(), SIGNAL(bulkUpdateStarted()));
+    QSignalSpy spyFinished(db.data(), SIGNAL(bulkUpdateFinished()));
+
+    db->beginBulkUpdate();
+    db->beginBulkUpdate();
+    QVERIFY(db->isBulkUpdating());
+    for (int i = 0; i < 100; ++i) {
+        auto* entry = new Entry();
+        entry->setGroup(db->rootGroup());
+    }
+    db->endBulkUpdate();
+    QVERIFY(db->isBulkUpdating());
+    QTest::qWait(200);
+    QCOMPARE(spyModified.count(), 0);
+
+    db->endBulkUpdate();
+    QVERIFY(!db->isBulkUpdating());
+    QCOMPARE(spyStarted.count(), 1);
+    QCOMPARE(spyFinished.count(), 1);
+    QTest::qWait(200);
+    QCOMPARE(spyModified.count(), 1);
+
+    // an explicit modification is reported once when the update finishes
+    db->beginBulkUpdate();
+    db->rootGroup()->entries().first()->setTitle("changed");
+    db->markAsModified();
+    QCOMPARE(spyModified.count(), 1);
+    db->endBulkUpdate();
+    QCOMPARE(spyModified.count(), 2);
+    QTest::qWait(200);
+    QCOMPARE(spyModified.count(), 2);
+}
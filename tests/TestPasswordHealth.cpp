@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPasswordHealth.h"
+
+#include <QTest>
+
+#include "core/Clock.h"
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
+#include "core/PasswordHealth.h"
+#include "crypto/Crypto.h"
+
+QTEST_GUILESS_MAIN(TestPasswordHealth)
+
+namespace
+{
+    const QString StrongPassword("Vq8#mT2!xL9$wR4&zN7@kP3^");
+
+    Entry* createEntry(Group* group, const QString& title, const QString& password)
+    {
+        auto* entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(title);
+        entry->setPassword(password);
+        entry->setGroup(group);
+        return entry;
+    }
+
+    const PasswordHealth::Item* findItem(const QList<PasswordHealth::Item>& items, const Entry* entry)
+    {
+        for (const PasswordHealth::Item& item : items) {
+            if (item.entry == entry) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+} // namespace
+
+void TestPasswordHealth::initTestCase()
+{
+    QVERIFY(Crypto::init());
+}
+
+void TestPasswordHealth::testAnalyze()
+{
+    Database db;
+    db.metadata()->setRecycleBinEnabled(true);
+    Group* root = db.rootGroup();
+
+    Entry* weak1 = createEntry(root, "weak1", "password");
+    Entry* weak2 = createEntry(root, "weak2", "password");
+    Entry* strong = createEntry(root, "strong", StrongPassword);
+    Entry* empty = createEntry(root, "empty", "");
+    Entry* reference = createEntry(root, "reference", QString("{REF:P@I:%1}").arg(strong->uuidToHex()));
+    Entry* expired = createEntry(root, "expired", StrongPassword + "2");
+    expired->setExpires(true);
+    expired->setExpiryTime(Clock::currentDateTimeUtc().addDays(-1));
+    Entry* recycled = createEntry(root, "recycled", "password");
+    db.recycleEntry(recycled);
+
+    PasswordHealth health;
+    const QList<PasswordHealth::Item> items = health.analyze(&db);
+    QCOMPARE(items.size(), 6);
+    QVERIFY(!findItem(items, recycled));
+
+    const PasswordHealth::Item* item = findItem(items, weak1);
+    QVERIFY(item);
+    QCOMPARE(item->quality, PasswordHealth::Quality::Poor);
+    QCOMPARE(item->reuseCount, 2);
+    QVERIFY(item->hasProblems());
+    QCOMPARE(findItem(items, weak2)->reuseCount, 2);
+
+    item = findItem(items, strong);
+    QVERIFY(item);
+    QVERIFY(item->quality >= PasswordHealth::Quality::Good);
+    // references share the password on purpose
+    QCOMPARE(item->reuseCount, 1);
+    QVERIFY(!item->expired);
+    QVERIFY(!item->hasProblems());
+
+    item = findItem(items, reference);
+    QVERIFY(item);
+    QCOMPARE(item->entropy, findItem(items, strong)->entropy);
+    QCOMPARE(item->reuseCount, 1);
+
+    item = findItem(items, empty);
+    QVERIFY(item);
+    QCOMPARE(item->quality, PasswordHealth::Quality::Bad);
+    QCOMPARE(item->reuseCount, 1);
+    QVERIFY(item->hasProblems());
+
+    item = findItem(items, expired);
+    QVERIFY(item);
+    QVERIFY(item->expired);
+    QVERIFY(item->hasProblems());
+}
+
+void TestPasswordHealth::testIncrementalAnalyze()
+{
+    Database db;
+    Entry* entry1 = createEntry(db.rootGroup(), "entry1", "password");
+    createEntry(db.rootGroup(), "entry2", "password");
+    createEntry(db.rootGroup(), "entry3", StrongPassword);
+
+    PasswordHealth health;
+    QList<PasswordHealth::Item> items = health.analyze(&db);
+    QCOMPARE(health.cacheSize(), 2);
+    const double entropy = items.at(0).entropy;
+
+    entry1->setPassword(StrongPassword + "1");
+    items = health.analyze(&db);
+    QCOMPARE(health.cacheSize(), 3);
+    QCOMPARE(items.at(1).entropy, entropy);
+    QCOMPARE(items.at(0).reuseCount, 1);
+    QCOMPARE(items.at(1).reuseCount, 1);
+
+    // estimates of passwords no longer used are dropped
+    delete entry1;
+    health.analyze(&db);
+    QCOMPARE(health.cacheSize(), 2);
+
+    health.clearCache();
+    QCOMPARE(health.cacheSize(), 0);
+}
@@ -1,5 +1,5 @@
 /*
- *  Copyright (C) 2017 KeePassXC Team <team@keepassxc.org>
+ *  Copyright (C) 2018 KeePassXC Team <team@keepassxc.org>
  *
  *  This program is free software: you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -15,29 +15,19 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "Kdf.h"
+#ifndef KEEPASSXC_TESTPASSWORDHEALTH_H
+#define KEEPASSXC_TESTPASSWORDHEALTH_H
 
-#include <QThread>
+#include <QObject>
 
-#ifndef KEEPASSXC_KDF_P_H
-#define KEEPASSXC_KDF_P_H
-
-class Kdf::BenchmarkThread : public QThread
+class TestPasswordHealth : public QObject
 {
     Q_OBJECT
 
-public:
-    explicit BenchmarkThread(int msec, const Kdf* kdf);
-
-    int rounds();
-
-protected:
-    void run();
-
-private:
-    int m_rounds;
-    int m_msec;
-    const Kdf* m_kdf;
+private slots:
+    void initTestCase();
+    void testAnalyze();
+    void testIncrementalAnalyze();
 };
 
-#endif // KEEPASSXC_KDF_P_H
+#endif // KEEPASSXC_TESTPASSWORDHEALTH_H
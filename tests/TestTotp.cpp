@@ -115,6 +115,40 @@ void TestTotp::testSteamTotp()
     QCOMPARE(Totp::generateTotp(settings, time), QString("9P3VP"));
 }
 
+void TestTotp::testTotpContext()
+{
+    auto settings = Totp::createSettings("GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ", Totp::DEFAULT_DIGITS, Totp::DEFAULT_STEP);
+    auto context = Totp::createContext(settings);
+    QVERIFY(context->validKey);
+    QCOMPARE(context->step, Totp::DEFAULT_STEP);
+    QCOMPARE(context->digits, Totp::DEFAULT_DIGITS);
+    QCOMPARE(Totp::generateTotp(*context, 1234567890), QString("005924"));
+    QCOMPARE(Totp::generateTotp(*context, 1111111109), QString("081804"));
+
+    auto steamSettings = Totp::parseSettings("otpauth://totp/"
+                                             "test:test@example.com?secret=63BEDWCQZKTQWPESARIERL5DTTQFCJTK&issuer=Valve&"
+                                             "algorithm=SHA1&digits=5&period=30&encoder=steam");
+
+    // the batch generates the same codes as single calls
+    const QList<QSharedPointer<Totp::Context>> contexts = {context, Totp::createContext(steamSettings), {}};
+    const QStringList codes = Totp::generateTotps(contexts, 1511200518);
+    QCOMPARE(codes.size(), contexts.size());
+    QCOMPARE(codes[0], Totp::generateTotp(settings, 1511200518));
+    QCOMPARE(codes[1], QString("FR8RV"));
+    QCOMPARE(codes[2], QString());
+
+    // entries cache their context until the settings change
+    Entry entry;
+    QVERIFY(entry.totpContext().isNull());
+    entry.setTotp(settings);
+    auto entryContext = entry.totpContext();
+    QVERIFY(!entryContext.isNull());
+    QCOMPARE(entry.totpContext(), entryContext);
+    entry.setTotp(Totp::createSettings("GEZDGNBVGY3TQOJQGEZDGNBVGY3TQOJQ", 8, Totp::DEFAULT_STEP));
+    QVERIFY(entry.totpContext() != entryContext);
+    QCOMPARE(entry.totpContext()->digits, 8u);
+}
+
 void TestTotp::testEntryHistory()
 {
     Entry entry;
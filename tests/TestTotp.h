@@ -30,6 +30,7 @@ private slots:
     void testParseSecret();
     void testTotpCode();
     void testSteamTotp();
+    void testTotpContext();
     void testEntryHistory();
 };
 
@@ -18,6 +18,7 @@
 #include "TestWildcardMatcher.h"
 #include "TestGlobal.h"
 #include "autotype/WildcardMatcher.h"
+#include "autotype/WindowPattern.h"
 
 QTEST_GUILESS_MAIN(TestWildcardMatcher)
 
@@ -56,6 +57,59 @@ void TestWildcardMatcher::testMatcher()
     cleanupMatcher();
 }
 
+void TestWildcardMatcher::testWindowPattern_data()
+{
+    testMatcher_data();
+
+    QTest::newRow("MatchRegExp") << DefaultText << QString("//^SOME\\s+t.xt$//") << true;
+    QTest::newRow("NoMatchRegExp") << DefaultText << QString("//^text//") << false;
+    QTest::newRow("NoMatchInvalidRegExp") << DefaultText << QString("//some(//") << false;
+    QTest::newRow("MatchEmptyRegExp") << DefaultText << QString("////") << true;
+}
+
+void TestWildcardMatcher::testWindowPattern()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, pattern);
+    QFETCH(bool, match);
+
+    QCOMPARE(WindowPattern(pattern).matches(text), match);
+    // the shared cache returns the same result twice
+    QCOMPARE(WindowPattern::compile(pattern).matches(text), match);
+    QCOMPARE(WindowPattern::compile(pattern).matches(text), match);
+}
+
+void TestWildcardMatcher::benchmarkWindowPatterns()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QStringList patterns;
+    for (int i = 0; i < 10000; ++i) {
+        if (i % 10 == 0) {
+            patterns << QString("//^Window %1 - .* Browser$//").arg(i);
+        } else {
+            patterns << QString("*Window %1 - *Browser").arg(i);
+        }
+    }
+    const QString windowTitle("Window 5000 - Some Page - Browser");
+
+    int matches = 0;
+    QBENCHMARK
+    {
+        matches = 0;
+        for (const QString& pattern : asConst(patterns)) {
+            if (WindowPattern::compile(pattern).matches(windowTitle)) {
+                ++matches;
+            }
+        }
+    }
+    QCOMPARE(matches, 1);
+}
+
 void TestWildcardMatcher::initMatcher(QString text)
 {
     m_matcher = new WildcardMatcher(text);
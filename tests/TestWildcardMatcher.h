@@ -29,6 +29,9 @@ class TestWildcardMatcher : public QObject
 private slots:
     void testMatcher();
     void testMatcher_data();
+    void testWindowPattern();
+    void testWindowPattern_data();
+    void benchmarkWindowPatterns();
 
 private:
     static const QString DefaultText;
@@ -120,7 +120,9 @@ void TestGui::init()
     QTest::keyClicks(editPassword, "a");
     QTest::keyClick(editPassword, Qt::Key_Enter);
 
+    // the database is unlocked in the background
     QTRY_VERIFY(m_tabWidget->currentDatabaseWidget());
+    QTRY_VERIFY(m_tabWidget->currentDatabaseWidget()->dbHasKey());
 
     m_dbWidget = m_tabWidget->currentDatabaseWidget();
     m_db = m_dbWidget->database();